@@ -0,0 +1,473 @@
+// ***********************************************************************
+//                            Sorting Benchmark Harness
+// ***********************************************************************
+//
+// Runs every Sorting member (plus std::sort and std::stable_sort as baselines)
+// over a grid of element types, input distributions and sizes, and writes one
+// CSV row or JSON object per combination. Inputs come from a fixed seed and rows
+// are emitted in a fixed order, so two result files can be diffed directly.
+//
+// ** Build: **
+//  g++ -std=c++20 -O2 -pthread sortingAlgorithmsBenchmark.cpp -o sortingAlgorithmsBenchmark
+//
+// ** Options: **
+//  --min-size N          Smallest size (default 10); sizes grow by a factor of 10
+//  --max-size N          Largest size (default 1000000, up to 1000000000)
+//  --repetitions N       Timed runs per combination (default 5)
+//  --warmups N           Untimed runs per combination (default 1)
+//  --threads N           Thread count passed to Sorting (default 1, 0 = all cores)
+//  --quadratic-cap N     Largest size for O(n^2) algorithms (default 16384)
+//  --memory-limit-mb N   Skip sizes whose working set exceeds N MiB (default 16384)
+//  --swaps N             Swaps applied to the nearly-sorted input (default n / 100)
+//  --seed N              Seed of the input generator (default 42)
+//  --algorithms a,b,..   Subset of algorithms to run (default all)
+//  --types a,b,..        Subset of int32,int64,double,string,record16,record64
+//  --distributions a,..  Subset of uniform,sorted,reverse,organ-pipe,few-unique,
+//                        zipf,nearly-sorted
+//  --format csv|json     Output format (default csv)
+//  --output FILE         Output file (default stdout)
+//
+// The vectorized kernels are used whenever the CPU supports them; run with the 
+// environment variable SORTING_SIMD=scalar (or avx2) to time the scalar code instead. 
+// The level in effect is reported in the simd column.
+//
+// ** Reported columns: **
+//  - median_ns and p99_ns over the timed repetitions (nearest-rank percentile)
+//  - ns_per_element = median_ns / size
+//  - sorted is false if any run's output differed from the reference: the 
+//    std::stable_sort result for stable algorithms, its keys for the others (records 
+//    carry their input position, so a lost or duplicated record is caught as well)
+//
+// ***********************************************************************
+
+#include "sortingAlgorithmsHeader.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+
+namespace {
+
+// Records compare by key only; position is their index in the input.
+struct Record16 {
+    std::uint64_t key;
+    std::uint64_t position;
+
+    bool operator<(const Record16& other) const { return key < other.key; }
+    bool operator==(const Record16&) const = default;
+};
+
+struct Record64 {
+    std::uint64_t key;
+    std::uint64_t position;
+    std::uint8_t payload[48];
+
+    bool operator<(const Record64& other) const { return key < other.key; }
+    bool operator==(const Record64&) const = default;
+};
+
+template <typename T>
+constexpr bool isRecord{std::is_same_v<T, Record16> || std::is_same_v<T, Record64>};
+
+struct Options {
+    size_t minSize{10};
+    size_t maxSize{1000000};
+    size_t repetitions{5};
+    size_t warmups{1};
+    unsigned threads{1};
+    size_t quadraticCap{16384};
+    size_t memoryLimitMb{16384};
+    size_t swaps{};
+    std::uint64_t seed{42};
+    std::vector<std::string> algorithms;
+    std::vector<std::string> types;
+    std::vector<std::string> distributions;
+    std::string format{"csv"};
+    std::string output;
+};
+
+struct Result {
+    std::string algorithm;
+    std::string type;
+    std::string distribution;
+    size_t size;
+    double medianNs;
+    double p99Ns;
+    bool sorted;
+};
+
+const std::vector<std::string> allDistributions{
+    "uniform", "sorted", "reverse", "organ-pipe", "few-unique", "zipf", "nearly-sorted"};
+
+std::vector<std::string> splitList(const std::string& list) {
+    std::vector<std::string> items;
+    std::stringstream stream{list};
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+bool selected(const std::vector<std::string>& filter, const std::string& name) {
+    return filter.empty() || std::find(filter.begin(), filter.end(), name) != filter.end();
+}
+
+// ---------------------------------------------------------------------------
+// Input generation
+// ---------------------------------------------------------------------------
+
+template <typename T>
+T randomValue(std::mt19937_64& rng) {
+    if constexpr (std::is_same_v<T, double>) {
+        return std::uniform_real_distribution<double>{-1e9, 1e9}(rng);
+    }
+    else if constexpr (std::is_same_v<T, std::string>) {
+        size_t length{8 + rng() % 17};
+        std::string value(length, 'a');
+        for (char& c : value) {
+            c = static_cast<char>('a' + rng() % 26);
+        }
+        return value;
+    }
+    else if constexpr (std::is_same_v<T, Record16>) {
+        return Record16{rng(), rng()};
+    }
+    else if constexpr (std::is_same_v<T, Record64>) {
+        Record64 value{rng(), 0, {}};
+        value.payload[0] = static_cast<std::uint8_t>(value.key);
+        return value;
+    }
+    else {
+        return static_cast<T>(rng());
+    }
+}
+
+template <typename T>
+std::vector<T> makeValues(const std::string& distribution, size_t size, const Options& options) {
+    std::mt19937_64 rng{options.seed ^ (size * 0x9E3779B97F4A7C15ull)};
+    std::vector<T> values(size);
+
+    if (distribution == "few-unique" || distribution == "zipf") {
+        size_t distinct{distribution == "few-unique" ? size_t{16} : std::min<size_t>(size, 100000)};
+        std::vector<T> pool(distinct);
+        for (T& value : pool) {
+            value = randomValue<T>(rng);
+        }
+        if (distribution == "few-unique") {
+            for (T& value : values) {
+                value = pool[rng() % distinct];
+            }
+        }
+        else {
+            // Zipf with exponent 1: P(rank r) ~ 1 / r.
+            std::vector<double> cdf(distinct);
+            double total{};
+            for (size_t rank{}; rank < distinct; ++rank) {
+                total += 1.0 / static_cast<double>(rank + 1);
+                cdf[rank] = total;
+            }
+            std::uniform_real_distribution<double> uniform{0.0, total};
+            for (T& value : values) {
+                size_t rank{static_cast<size_t>(std::upper_bound(cdf.begin(), cdf.end(), uniform(rng)) - cdf.begin())};
+                value = pool[std::min(rank, distinct - 1)];
+            }
+        }
+        return values;
+    }
+
+    for (T& value : values) {
+        value = randomValue<T>(rng);
+    }
+    if (distribution == "uniform") {
+        return values;
+    }
+
+    std::sort(values.begin(), values.end());
+    if (distribution == "reverse") {
+        std::reverse(values.begin(), values.end());
+    }
+    else if (distribution == "organ-pipe") {
+        // Smallest keys at both ends, largest in the middle.
+        std::vector<T> pipe(size);
+        size_t front{}, back{size};
+        for (size_t i{}; i < size; ++i) {
+            if (i % 2 == 0) {
+                pipe[front++] = std::move(values[i]);
+            }
+            else {
+                pipe[--back] = std::move(values[i]);
+            }
+        }
+        values = std::move(pipe);
+    }
+    else if (distribution == "nearly-sorted" && size > 1) {
+        size_t swaps{options.swaps != 0 ? options.swaps : std::max<size_t>(1, size / 100)};
+        for (size_t i{}; i < swaps; ++i) {
+            std::swap(values[rng() % size], values[rng() % size]);
+        }
+    }
+    return values;
+}
+
+template <typename T>
+std::vector<T> makeInput(const std::string& distribution, size_t size, const Options& options) {
+    std::vector<T> values{makeValues<T>(distribution, size, options)};
+    if constexpr (isRecord<T>) {
+        for (size_t i{}; i < size; ++i) {
+            values[i].position = i;
+        }
+    }
+    return values;
+}
+
+// ---------------------------------------------------------------------------
+// Algorithms
+// ---------------------------------------------------------------------------
+
+template <typename T>
+struct Algorithm {
+    std::string name;
+    bool quadratic;
+    bool stable;
+    std::function<void(Sorting&, std::vector<T>&)> run;
+};
+
+template <typename T>
+constexpr bool radixSortable{(std::is_integral_v<T> && !std::is_same_v<T, bool>)
+                             || std::is_floating_point_v<T> || std::is_same_v<T, std::string>};
+
+template <typename T>
+std::vector<Algorithm<T>> algorithmsFor() {
+    std::vector<Algorithm<T>> algorithms{
+        {"std::sort", false, false, [](Sorting&, std::vector<T>& vec) { std::sort(vec.begin(), vec.end()); }},
+        {"std::stable_sort", false, true, [](Sorting&, std::vector<T>& vec) { std::stable_sort(vec.begin(), vec.end()); }},
+        {"bubbleSort", true, true, [](Sorting& sorting, std::vector<T>& vec) { sorting.bubbleSort(vec); }},
+        {"insertionSort", true, true, [](Sorting& sorting, std::vector<T>& vec) { sorting.insertionSort(vec); }},
+        {"selectionSort", true, false, [](Sorting& sorting, std::vector<T>& vec) { sorting.selectionSort(vec); }},
+        {"heapSort", false, false, [](Sorting& sorting, std::vector<T>& vec) { sorting.heapSort(vec); }},
+        {"mergeSort", false, true, [](Sorting& sorting, std::vector<T>& vec) {
+            if (!vec.empty()) sorting.mergeSort(vec, 0, vec.size() - 1);
+        }},
+        {"quickSort", false, false, [](Sorting& sorting, std::vector<T>& vec) {
+            if (!vec.empty()) sorting.quickSort(vec, 0, vec.size() - 1);
+        }},
+        {"bucketSort", false, true, [](Sorting& sorting, std::vector<T>& vec) { sorting.bucketSort(vec); }},
+        {"powerSort", false, true, [](Sorting& sorting, std::vector<T>& vec) { sorting.powerSort(vec); }},
+    };
+    if constexpr (radixSortable<T>) {
+        algorithms.push_back({"countingSort", false, true, [](Sorting& sorting, std::vector<T>& vec) { sorting.countingSort(vec); }});
+        algorithms.push_back({"radixSort", false, true, [](Sorting& sorting, std::vector<T>& vec) { sorting.radixSort(vec); }});
+    }
+    return algorithms;
+}
+
+// ---------------------------------------------------------------------------
+// Measurement
+// ---------------------------------------------------------------------------
+
+template <typename T>
+size_t approximateBytes(size_t size) {
+    // Input, reference, working copy and one scratch buffer; strings also own their 
+    // characters.
+    size_t perElement{sizeof(T) + (std::is_same_v<T, std::string> ? 24 : 0)};
+    return 4 * size * perElement;
+}
+
+// Checks output against reference, the std::stable_sort result of input. Stable 
+// algorithms must reproduce it exactly; the others must produce the same keys, and 
+// every record exactly once.
+template <typename T>
+bool matchesReference(const std::vector<T>& input, const std::vector<T>& output, 
+                      const std::vector<T>& reference, bool stable) {
+    if (output.size() != reference.size()) {
+        return false;
+    }
+    if (stable) {
+        return output == reference;
+    }
+    for (size_t i{}; i < output.size(); ++i) {
+        if (output[i] < reference[i] || reference[i] < output[i]) {
+            return false;
+        }
+    }
+    if constexpr (isRecord<T>) {
+        std::vector<bool> seen(input.size());
+        for (const T& value : output) {
+            if (value.position >= input.size() || seen[value.position] || !(value == input[value.position])) {
+                return false;
+            }
+            seen[value.position] = true;
+        }
+    }
+    return true;
+}
+
+template <typename T>
+void runType(const std::string& typeName, const Options& options, std::vector<Result>& results) {
+    if (!selected(options.types, typeName)) {
+        return;
+    }
+    Sorting sorting{options.threads};
+    std::vector<Algorithm<T>> algorithms{algorithmsFor<T>()};
+
+    for (const std::string& distribution : allDistributions) {
+        if (!selected(options.distributions, distribution)) {
+            continue;
+        }
+        for (size_t size{options.minSize}; size <= options.maxSize; size *= 10) {
+            if (approximateBytes<T>(size) > options.memoryLimitMb * (size_t{1} << 20)) {
+                std::cerr << "skipping " << typeName << " " << distribution << " n=" << size
+                          << ": exceeds --memory-limit-mb\n";
+                break;
+            }
+            const std::vector<T> input{makeInput<T>(distribution, size, options)};
+            std::vector<T> reference{input};
+            std::stable_sort(reference.begin(), reference.end());
+
+            for (const Algorithm<T>& algorithm : algorithms) {
+                if (!selected(options.algorithms, algorithm.name)
+                    || (algorithm.quadratic && size > options.quadraticCap)) {
+                    continue;
+                }
+                std::cerr << algorithm.name << " " << typeName << " " << distribution << " n=" << size << "\n";
+
+                std::vector<T> work;
+                bool sorted{true};
+                for (size_t i{}; i < options.warmups; ++i) {
+                    work = input;
+                    algorithm.run(sorting, work);
+                }
+                std::vector<double> timesNs;
+                for (size_t i{}; i < options.repetitions; ++i) {
+                    work = input;
+                    auto start{std::chrono::steady_clock::now()};
+                    algorithm.run(sorting, work);
+                    auto stop{std::chrono::steady_clock::now()};
+                    timesNs.push_back(std::chrono::duration<double, std::nano>(stop - start).count());
+                    sorted = sorted && matchesReference(input, work, reference, algorithm.stable);
+                }
+
+                std::sort(timesNs.begin(), timesNs.end());
+                size_t count{timesNs.size()};
+                double median{count % 2 == 1 ? timesNs[count / 2]
+                                             : (timesNs[count / 2 - 1] + timesNs[count / 2]) / 2};
+                size_t p99Rank{static_cast<size_t>(std::ceil(0.99 * static_cast<double>(count)))};
+                double p99{timesNs[std::max<size_t>(p99Rank, 1) - 1]};
+                results.push_back({algorithm.name, typeName, distribution, size, median, p99, sorted});
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Output
+// ---------------------------------------------------------------------------
+
+void writeCsv(std::ostream& out, const Options& options, const std::vector<Result>& results) {
+    out << "algorithm,type,distribution,size,threads,simd,repetitions,median_ns,p99_ns,ns_per_element,sorted\n";
+    for (const Result& result : results) {
+        out << result.algorithm << ',' << result.type << ',' << result.distribution << ','
+            << result.size << ',' << options.threads << ',' << simdLevelName(simdLevel()) << ',' << options.repetitions << ','
+            << result.medianNs << ',' << result.p99Ns << ','
+            << result.medianNs / static_cast<double>(result.size) << ','
+            << (result.sorted ? "true" : "false") << '\n';
+    }
+}
+
+void writeJson(std::ostream& out, const Options& options, const std::vector<Result>& results) {
+    out << "{\n  \"threads\": " << options.threads
+        << ",\n  \"simd\": \"" << simdLevelName(simdLevel()) << '"'
+        << ",\n  \"repetitions\": " << options.repetitions
+        << ",\n  \"warmups\": " << options.warmups
+        << ",\n  \"seed\": " << options.seed
+        << ",\n  \"results\": [\n";
+    for (size_t i{}; i < results.size(); ++i) {
+        const Result& result{results[i]};
+        out << "    {\"algorithm\": \"" << result.algorithm
+            << "\", \"type\": \"" << result.type
+            << "\", \"distribution\": \"" << result.distribution
+            << "\", \"size\": " << result.size
+            << ", \"median_ns\": " << result.medianNs
+            << ", \"p99_ns\": " << result.p99Ns
+            << ", \"ns_per_element\": " << result.medianNs / static_cast<double>(result.size)
+            << ", \"sorted\": " << (result.sorted ? "true" : "false") << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+Options parseOptions(int argc, char* argv[]) {
+    Options options;
+    for (int i{1}; i < argc; ++i) {
+        std::string flag{argv[i]};
+        if (i + 1 >= argc) {
+            std::cerr << "missing value for " << flag << "\n";
+            std::exit(2);
+        }
+        std::string value{argv[++i]};
+        if (flag == "--min-size") options.minSize = std::max<size_t>(1, std::stoull(value));
+        else if (flag == "--max-size") options.maxSize = std::stoull(value);
+        else if (flag == "--repetitions") options.repetitions = std::max<size_t>(1, std::stoull(value));
+        else if (flag == "--warmups") options.warmups = std::stoull(value);
+        else if (flag == "--threads") options.threads = static_cast<unsigned>(std::stoul(value));
+        else if (flag == "--quadratic-cap") options.quadraticCap = std::stoull(value);
+        else if (flag == "--memory-limit-mb") options.memoryLimitMb = std::stoull(value);
+        else if (flag == "--swaps") options.swaps = std::stoull(value);
+        else if (flag == "--seed") options.seed = std::stoull(value);
+        else if (flag == "--algorithms") options.algorithms = splitList(value);
+        else if (flag == "--types") options.types = splitList(value);
+        else if (flag == "--distributions") options.distributions = splitList(value);
+        else if (flag == "--format") options.format = value;
+        else if (flag == "--output") options.output = value;
+        else {
+            std::cerr << "unknown option " << flag << "\n";
+            std::exit(2);
+        }
+    }
+    if (options.format != "csv" && options.format != "json") {
+        std::cerr << "--format must be csv or json\n";
+        std::exit(2);
+    }
+    return options;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options{parseOptions(argc, argv)};
+
+    std::vector<Result> results;
+    runType<std::int32_t>("int32", options, results);
+    runType<std::int64_t>("int64", options, results);
+    runType<double>("double", options, results);
+    runType<std::string>("string", options, results);
+    runType<Record16>("record16", options, results);
+    runType<Record64>("record64", options, results);
+
+    std::ofstream file;
+    if (!options.output.empty()) {
+        file.open(options.output);
+        if (!file) {
+            std::cerr << "cannot open " << options.output << "\n";
+            return 1;
+        }
+    }
+    std::ostream& out{options.output.empty() ? std::cout : file};
+    out.precision(10);
+    if (options.format == "json") {
+        writeJson(out, options, results);
+    }
+    else {
+        writeCsv(out, options, results);
+    }
+
+    bool allSorted{std::all_of(results.begin(), results.end(), [](const Result& result) { return result.sorted; })};
+    return allSorted ? 0 : 1;
+}
@@ -4,16 +4,335 @@
 #include <iostream>
 #include <vector>
 #include <algorithm> 
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
 
-class Sorting {
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#if !defined(SORTING_NO_SIMD) && defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SORTING_SIMD 1
+#include <immintrin.h>
+#endif
+
+// Phases whose wall-clock time CountingInstrumentation accumulates.
+enum class SortPhase : size_t {
+    partition,
+    heapify,
+    merge,
+    insertion,
+    histogram,
+    scatter,
+    count
+};
+
+inline const char* sortPhaseName(SortPhase phase) {
+    static constexpr const char* names[]{"partition", "heapify", "merge", "insertion", "histogram", "scatter"};
+    return names[static_cast<size_t>(phase)];
+}
+
+// Instruction set used by the vectorized kernels of quickSort and mergeSort.
+enum class SimdLevel : size_t {
+    scalar,
+    avx2,
+    avx512
+};
+
+// Best level supported by the CPU, capped by the SORTING_SIMD environment variable.
+inline SimdLevel simdLevel();
+inline const char* simdLevelName(SimdLevel level);
+
+// Default policy: every hook is empty, so an instrumented call compiles to the 
+// same code as an uninstrumented one.
+struct NoInstrumentation {
+    struct Phase {};
+
+    void beginCall() {}
+    void endCall() {}
+    void countComparison() {}
+    void countSwap() {}
+    void countMoves(size_t) {}
+    void recordDepth(size_t) {}
+    void countAllocation(size_t) {}
+    Phase phase(SortPhase) { return {}; }
+};
+
+struct SortStatistics {
+    std::uint64_t comparisons{};
+    std::uint64_t swaps{};
+    std::uint64_t moves{};
+    std::uint64_t maxDepth{};
+    std::uint64_t bytesAllocated{};
+    std::array<std::uint64_t, static_cast<size_t>(SortPhase::count)> phaseNanoseconds{};
+};
+
+// Counts comparisons, swaps, element moves, recursion depth, bytes allocated and 
+// time per phase. Counters are reset when a top-level Sorting call starts, so 
+// statistics() describes the most recent call. Phase times are summed over threads.
+class CountingInstrumentation {
+public:
+    class Phase {
+    public:
+        Phase(CountingInstrumentation& owner, SortPhase phase)
+            : owner{owner}, phase{phase}, start{std::chrono::steady_clock::now()} {}
+        Phase(const Phase&) = delete;
+        Phase& operator=(const Phase&) = delete;
+        ~Phase() {
+            auto elapsed{std::chrono::steady_clock::now() - start};
+            owner.phaseNanoseconds[static_cast<size_t>(phase)].fetch_add(
+                static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+                std::memory_order_relaxed);
+        }
+
+    private:
+        CountingInstrumentation& owner;
+        SortPhase phase;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    void beginCall() {
+        if (callDepth++ == 0) {
+            reset();
+        }
+    }
+    void endCall() { --callDepth; }
+    void countComparison() { comparisons.fetch_add(1, std::memory_order_relaxed); }
+    void countSwap() { swaps.fetch_add(1, std::memory_order_relaxed); }
+    void countMoves(size_t count) { moves.fetch_add(count, std::memory_order_relaxed); }
+    void countAllocation(size_t bytes) { bytesAllocated.fetch_add(bytes, std::memory_order_relaxed); }
+    void recordDepth(size_t depth) {
+        std::uint64_t current{maxDepth.load(std::memory_order_relaxed)};
+        while (depth > current && !maxDepth.compare_exchange_weak(current, depth, std::memory_order_relaxed)) {}
+    }
+    Phase phase(SortPhase phase) { return Phase{*this, phase}; }
+
+    SortStatistics statistics() const {
+        SortStatistics result;
+        result.comparisons = comparisons.load(std::memory_order_relaxed);
+        result.swaps = swaps.load(std::memory_order_relaxed);
+        result.moves = moves.load(std::memory_order_relaxed);
+        result.maxDepth = maxDepth.load(std::memory_order_relaxed);
+        result.bytesAllocated = bytesAllocated.load(std::memory_order_relaxed);
+        for (size_t i{}; i < result.phaseNanoseconds.size(); ++i) {
+            result.phaseNanoseconds[i] = phaseNanoseconds[i].load(std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    void reset() {
+        comparisons = 0;
+        swaps = 0;
+        moves = 0;
+        maxDepth = 0;
+        bytesAllocated = 0;
+        for (std::atomic<std::uint64_t>& nanoseconds : phaseNanoseconds) {
+            nanoseconds = 0;
+        }
+    }
+
+private:
+    std::atomic<std::uint64_t> comparisons{};
+    std::atomic<std::uint64_t> swaps{};
+    std::atomic<std::uint64_t> moves{};
+    std::atomic<std::uint64_t> maxDepth{};
+    std::atomic<std::uint64_t> bytesAllocated{};
+    std::array<std::atomic<std::uint64_t>, static_cast<size_t>(SortPhase::count)> phaseNanoseconds{};
+    size_t callDepth{};
+};
+
+// Configuration of BasicSorting::externalSort().
+struct ExternalSortOptions {
+    size_t recordSize{};                         // Bytes per fixed-width record
+    size_t memoryBudget{size_t{1} << 30};        // Bytes of RAM the sort may use
+    size_t ioBlockSize{size_t{4} << 20};         // Largest single read or write, in bytes
+    std::string tempDirectory;                   // Empty: std::filesystem::temp_directory_path()
+};
+
+namespace sortingDetail {
+class TaskGroup;
+class TaskPool;
+class GroupJoin;
+}
+
+#include "sortingAlgorithmsSimd.tpp"
+
+template <typename Instrumentation = NoInstrumentation>
+class BasicSorting {
 private:
+    static constexpr size_t insertionSortThreshold{32};
+    static constexpr size_t nintherThreshold{128};
+    static constexpr size_t mergeSortRunLength{32};
+    static constexpr size_t parallelGrain{size_t{1} << 14};
+    static constexpr size_t mergeVectorProbeSize{2048};
+    static constexpr size_t mergeVectorWindow{32};
+    static constexpr size_t mergeVectorSwitches{8};
+    static constexpr size_t mergeVectorBlock{1024};
+    static constexpr size_t countingSortRangeLimit{size_t{1} << 16};
+    static constexpr size_t stringInsertionThreshold{32};
+    static constexpr size_t bucketSortTargetSize{256};
+    static constexpr size_t bucketSortOversampling{16};
+    static constexpr size_t maxBucketCount{256};
+    static constexpr size_t heapArity{4};
+    static constexpr size_t powerSortMinRun{32};
+    static constexpr size_t initialMinGallop{7};
+    static constexpr size_t powerSortVectorHandOff{16};
+    static constexpr size_t powerSortVectorBlock{1024};
+
+    using TaskGroup = sortingDetail::TaskGroup;
+    using TaskPool = sortingDetail::TaskPool;
+    using GroupJoin = sortingDetail::GroupJoin;
+
+    // Calls the policy's beginCall()/endCall() around every public entry point.
+    class InstrumentedCall {
+    public:
+        explicit InstrumentedCall(Instrumentation& instrumentation) : instrumentation{instrumentation} {
+            instrumentation.beginCall();
+        }
+        ~InstrumentedCall() { instrumentation.endCall(); }
+
+    private:
+        Instrumentation& instrumentation;
+    };
+
+    unsigned threadCount;
+    [[no_unique_address]] Instrumentation instrumentation;
+
+    unsigned resolvedThreadCount() const;
+
+    template <typename A, typename B>
+    bool less(const A& a, const B& b) {
+        instrumentation.countComparison();
+        return a < b;
+    }
     template <typename T>
-    void heapify(std::vector<T>&, int, int);
-    template<typename T>
-    void merge(std::vector<T>&, size_t, size_t, size_t);
+    void swapElements(T& a, T& b) {
+        instrumentation.countSwap();
+        std::swap(a, b);
+    }
+
+    // The vectorized kernels serve std::int32_t, std::int64_t, float and double when the 
+    // policy does not instrument, since the counters describe the scalar algorithms. 
+    // Stable callers leave out floating point: +0.0 and -0.0 compare equal but differ.
+    template <typename T, bool Stable = false>
+    static constexpr bool vectorized{std::is_same_v<Instrumentation, NoInstrumentation> && sortingDetail::simd::supported<T>
+                                     && !(Stable && std::is_floating_point_v<T>)};
+
+    template <typename T>
+    static auto radixKey(T);
+    template <typename T>
+    void heapify(std::vector<T>&, size_t, size_t, size_t);
+    template <typename T>
+    void makeHeap(std::vector<T>&, size_t, size_t);
+    template <typename T>
+    void sortHeap(std::vector<T>&, size_t, size_t);
+    template <typename T>
+    void heapSortRange(std::vector<T>&, size_t, size_t);
+    template <typename Iterator>
+    void insertionSortRange(Iterator, Iterator);
+    template <bool Stable, typename T>
+    void sortSmallRange(T*, T*);
+    template <typename T>
+    void merge(T*, size_t, T*, size_t, T*);
+    template <typename T>
+    size_t coRank(size_t, const T*, size_t, const T*, size_t);
+    template <typename T>
+    void parallelMerge(TaskPool*, T*, size_t, T*, size_t, T*);
+    template <typename T>
+    void mergeSortRange(TaskPool*, T*, T*, size_t, size_t, bool, size_t);
+    template <typename T>
+    void sortThree(std::vector<T>&, size_t, size_t, size_t);
+    template <typename T>
+    void choosePivot(std::vector<T>&, size_t, size_t);
+    template <typename T>
+    void breakPatterns(std::vector<T>&, size_t, size_t);
+    template <typename T>
+    size_t partition(std::vector<T>& vec, size_t first, size_t last);
+    template <typename T>
+    size_t partitionEqual(std::vector<T>& vec, size_t first, size_t last);
+    template <typename T>
+    void introSortLoop(TaskPool*, TaskGroup*, std::vector<T>&, size_t, size_t, size_t, size_t, size_t);
     template <typename T>
-    int partition(std::vector<T>& vec, size_t left, size_t right);
+    void medianOfMediansPivot(std::vector<T>&, size_t, size_t);
+    template <typename T>
+    void selectRange(std::vector<T>&, size_t, size_t, size_t, size_t);
+    // Merge buffer and galloping threshold shared by all merges of one powerSort call.
+    template <typename T>
+    struct RunMergeState {
+        std::unique_ptr<T[]> buffer;
+        size_t capacity{};
+        size_t minGallop{initialMinGallop};
+        size_t vectorWidth{};       // Lanes of the vectorized merge, 0 when it does not apply
+        bool blockMerging{};        // The last vector block interleaved evenly: start with one
+    };
+    template <typename T, typename Before>
+    size_t countRun(T*, T*, Before&);
+    template <typename T, typename Before>
+    void binaryInsertionSort(T*, T*, T*, Before&);
+    template <bool Upper, typename T, typename Before>
+    size_t gallop(const T&, const T*, size_t, size_t, Before&);
+    template <typename T, typename Before>
+    void mergeLow(T*, size_t, size_t, RunMergeState<T>&, Before&);
+    template <typename T, typename Before>
+    void mergeHigh(T*, size_t, size_t, RunMergeState<T>&, Before&);
+    template <typename T, typename Before>
+    void mergeRuns(T*, size_t, size_t, RunMergeState<T>&, Before&);
+    template <typename KeyExtractor>
+    void mergeExternalRuns(const std::vector<std::string>&, const std::string&, size_t, size_t, KeyExtractor&);
 public:
+    // Keeps the k smallest values pushed so far in a bounded heap, for streams too large 
+    // to hold in memory. Created by topKStream().
+    template <typename T>
+    class TopKStream {
+    public:
+        TopKStream(BasicSorting& sorting, size_t k) : sorting{sorting}, k{k} { heap.reserve(k); }
+
+        // A value is only copied (or moved) into the heap if it is kept.
+        void push(const T& value) { insert(value); }
+        void push(T&& value) { insert(std::move(value)); }
+        size_t size() const { return heap.size(); }
+        // The values kept so far, in ascending order.
+        std::vector<T> sorted() const;
+
+    private:
+        template <typename U>
+        void insert(U&& value);
+
+        BasicSorting& sorting;
+        size_t k;
+        std::vector<T> heap;
+    };
+
+    // threadCount == 1 keeps every algorithm single-threaded; 0 uses all hardware threads.
+    explicit BasicSorting(unsigned threads = 1) : threadCount{threads} {}
+
+    void setThreadCount(unsigned threads) { threadCount = threads; }
+    unsigned getThreadCount() const { return threadCount; }
+
+    // Counters of the instrumentation policy, e.g. getInstrumentation().statistics().
+    const Instrumentation& getInstrumentation() const { return instrumentation; }
+    Instrumentation& getInstrumentation() { return instrumentation; }
+
     template <typename T>
     void bubbleSort(std::vector<T>&);
     template <typename T>
@@ -23,14 +342,40 @@ public:
     template <typename T>
     void countingSort(std::vector<T>&);
     template <typename T>
+    void radixSort(std::vector<T>&);
+    void radixSort(std::vector<std::string>&);
+    template <typename T>
     void heapSort(std::vector<T>&);
     template <typename T>
     void mergeSort(std::vector<T>&, size_t, size_t);
     template <typename T>
-    void quickSort(std::vector<T>&, int, int);
+    void quickSort(std::vector<T>&, size_t, size_t);
     template <typename T>
     void selectionSort(std::vector<T>&);
+    // Stable and adaptive: natural runs are merged by the Powersort policy, so presorted 
+    // input takes O(n). Elements are ordered by compare(projection(a), projection(b)).
+    template <typename T, typename Compare = std::less<>, typename Projection = std::identity>
+    void powerSort(std::vector<T>&, Compare compare = {}, Projection projection = {});
+    // Rearranges vec so that vec[nth] is the element a full sort would put there, with 
+    // no greater element before it and no smaller one after it.
+    template <typename T>
+    void nthElement(std::vector<T>&, size_t nth);
+    // Sorts the k smallest elements into vec[0, k); the rest are left in unspecified order.
+    template <typename T>
+    void partialSort(std::vector<T>&, size_t k);
+    // Returns the k smallest elements of vec in ascending order.
+    template <typename T>
+    std::vector<T> topK(const std::vector<T>&, size_t k);
+    template <typename T>
+    TopKStream<T> topKStream(size_t k) { return TopKStream<T>{*this, k}; }
+    // Sorts a file of fixed-width records that may be larger than RAM; key(record) 
+    // returns the sort key of the record starting at `record`.
+    template <typename KeyExtractor>
+    void externalSort(const std::string& inputPath, const std::string& outputPath, 
+                      const ExternalSortOptions& options, KeyExtractor key);
 };
 
+using Sorting = BasicSorting<>;
+
 #include "sortingAlgorithmsImplementation.tpp"
 #endif
\ No newline at end of file
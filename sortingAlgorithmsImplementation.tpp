@@ -1,3 +1,212 @@
+// ***********************************************************************
+//                            Work-Stealing Task Pool
+// ***********************************************************************
+//
+// ** Characteristics: **
+//  - Fork-join pool used by the parallel modes of mergeSort and quickSort.
+//  - Every thread (the calling thread is slot 0) owns a deque of tasks. A thread 
+//    pushes and pops at the back of its own deque and steals from the front of 
+//    the others' deques when it runs dry, so large, old tasks are stolen first.
+//  - wait() never blocks: the waiting thread keeps executing queued tasks until 
+//    its group is finished, so nested fork-join cannot deadlock.
+//  - The first exception thrown by a task is stored in its group and rethrown 
+//    from wait().
+//  - Every fork site holds a GroupJoin, which joins the group when the scope is 
+//    left, so an exception thrown by the forking thread cannot destroy a group 
+//    (or the data its tasks capture) while queued tasks still point to it.
+//  - A pool only lives for the duration of one sort call. Tasks still queued when 
+//    it is destroyed are dropped, not run.
+//
+// ***********************************************************************
+
+namespace sortingDetail {
+
+class TaskGroup {
+private:
+    friend class TaskPool;
+    std::atomic<size_t> pending{};
+    std::mutex errorMutex;
+    std::exception_ptr error;
+};
+
+class TaskPool {
+public:
+    explicit TaskPool(unsigned threadCount)
+        : previousPool{currentPool}, previousSlot{currentSlot} {
+        for (unsigned i{}; i < threadCount; ++i) {
+            queues.push_back(std::make_unique<WorkerQueue>());
+        }
+        currentPool = this;
+        currentSlot = 0;
+        for (unsigned i{1}; i < threadCount; ++i) {
+            workers.emplace_back([this, i] { workerLoop(i); });
+        }
+    }
+
+    ~TaskPool() {
+        {
+            std::lock_guard<std::mutex> lock{sleepMutex};
+            stopping.store(true, std::memory_order_release);
+        }
+        wakeUp.notify_all();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        queues.clear();
+        currentPool = previousPool;
+        currentSlot = previousSlot;
+    }
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    size_t size() const {
+        return queues.size();
+    }
+
+    void run(TaskGroup& group, std::function<void()> work) {
+        group.pending.fetch_add(1, std::memory_order_relaxed);
+        queuedTasks.fetch_add(1, std::memory_order_release);
+        try {
+            WorkerQueue& queue{*queues[slot()]};
+            std::lock_guard<std::mutex> lock{queue.mutex};
+            queue.tasks.push_back({std::move(work), &group});
+        }
+        catch (...) {
+            queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+            group.pending.fetch_sub(1, std::memory_order_release);
+            throw;
+        }
+        {
+            std::lock_guard<std::mutex> lock{sleepMutex};
+        }
+        wakeUp.notify_one();
+    }
+
+    void wait(TaskGroup& group) {
+        join(group);
+        if (group.error) {
+            std::rethrow_exception(group.error);
+        }
+    }
+
+    // Like wait(), but leaves the group's exception where it is.
+    void join(TaskGroup& group) noexcept {
+        while (group.pending.load(std::memory_order_acquire) > 0) {
+            if (!runOne(slot())) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    struct Task {
+        std::function<void()> work;
+        TaskGroup* group;
+    };
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    size_t slot() const {
+        return currentPool == this ? currentSlot : 0;
+    }
+
+    bool runOne(size_t self) {
+        Task task;
+        bool found{};
+        {
+            WorkerQueue& own{*queues[self]};
+            std::lock_guard<std::mutex> lock{own.mutex};
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                found = true;
+            }
+        }
+        for (size_t offset{1}; !found && offset < queues.size(); ++offset) {
+            WorkerQueue& victim{*queues[(self + offset) % queues.size()]};
+            std::lock_guard<std::mutex> lock{victim.mutex};
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                found = true;
+            }
+        }
+        if (!found) {
+            return false;
+        }
+        queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+
+        try {
+            task.work();
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock{task.group->errorMutex};
+            if (!task.group->error) {
+                task.group->error = std::current_exception();
+            }
+        }
+        task.group->pending.fetch_sub(1, std::memory_order_release);
+        return true;
+    }
+
+    void workerLoop(size_t self) {
+        currentPool = this;
+        currentSlot = self;
+        while (!stopping.load(std::memory_order_acquire)) {
+            if (runOne(self)) {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock{sleepMutex};
+            wakeUp.wait(lock, [this] {
+                return stopping.load(std::memory_order_relaxed) || queuedTasks.load(std::memory_order_acquire) > 0;
+            });
+        }
+    }
+
+    inline static thread_local TaskPool* currentPool{};
+    inline static thread_local size_t currentSlot{};
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> queuedTasks{};
+    std::atomic<bool> stopping{};
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+    TaskPool* previousPool;
+    size_t previousSlot;
+};
+
+class GroupJoin {
+public:
+    GroupJoin(TaskPool& pool, TaskGroup& group)
+        : pool{pool}, group{group} {}
+
+    ~GroupJoin() {
+        pool.join(group);
+    }
+
+    GroupJoin(const GroupJoin&) = delete;
+    GroupJoin& operator=(const GroupJoin&) = delete;
+
+private:
+    TaskPool& pool;
+    TaskGroup& group;
+};
+
+} // namespace sortingDetail
+
+template <typename Instrumentation>
+unsigned BasicSorting<Instrumentation>::resolvedThreadCount() const {
+    if (threadCount != 0) {
+        return threadCount;
+    }
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
 // ***********************************************************************
 //                            Bubble Sort Algorithm
 // ***********************************************************************
@@ -25,15 +234,17 @@
 //
 // ***********************************************************************
 
+template <typename Instrumentation>
 template <typename T>
-void Sorting::bubbleSort(std::vector<T>& vec) {
+void BasicSorting<Instrumentation>::bubbleSort(std::vector<T>& vec) {
+    InstrumentedCall call{instrumentation};
     bool swapped{};
     size_t size{vec.size()};
     for (size_t i{}; i < size; ++i) {
         swapped = false;
         for (size_t j{}; j < size - i - 1; ++j) {
-            if (vec[j + 1] < vec[j]) {
-                std::swap(vec[j + 1], vec[j]);
+            if (less(vec[j + 1], vec[j])) {
+                swapElements(vec[j + 1], vec[j]);
                 swapped = true;
             }
         }
@@ -70,19 +281,50 @@ void Sorting::bubbleSort(std::vector<T>& vec) {
 //
 // ***********************************************************************
 
-template <typename T>
-void Sorting::insertionSort(std::vector<T>& vec) {
-    size_t size{vec.size()};
-    T key{};
-    for (size_t i{1}; i < size; ++i) {
-        size_t j{i - 1};
-        key = vec[i];
-        while (j >= 0 && vec[j] > key) {
-            vec[j + 1] = vec[j];
+template <typename Instrumentation>
+template <typename Iterator>
+void BasicSorting<Instrumentation>::insertionSortRange(Iterator first, Iterator last) {
+    if (first == last) {
+        return;
+    }
+    [[maybe_unused]] auto phase{instrumentation.phase(SortPhase::insertion)};
+    for (Iterator i{first + 1}; i < last; ++i) {
+        if (!less(*i, *(i - 1))) {
+            continue;
+        }
+        auto key{std::move(*i)};
+        Iterator j{i};
+        do {
+            *j = std::move(*(j - 1));
             --j;
+        } while (j > first && less(key, *(j - 1)));
+        *j = std::move(key);
+        instrumentation.countMoves(static_cast<size_t>(i - j) + 2);
+    }
+}
+
+template <typename Instrumentation>
+template <bool Stable, typename T>
+void BasicSorting<Instrumentation>::sortSmallRange(T* first, T* last) {
+    // Base case of quickSort and mergeSort: a vectorized sorting network where one 
+    // applies, Insertion Sort otherwise. Runs already in order skip the network, 
+    // which costs the same whatever the input.
+    if constexpr (vectorized<T, Stable>) {
+        if (std::is_sorted(first, last)) {
+            return;
+        }
+        if (sortingDetail::simd::sortNetwork(first, static_cast<size_t>(last - first))) {
+            return;
         }
-        vec[j + 1] = key;
     }
+    insertionSortRange(first, last);
+}
+
+template <typename Instrumentation>
+template <typename T>
+void BasicSorting<Instrumentation>::insertionSort(std::vector<T>& vec) {
+    InstrumentedCall call{instrumentation};
+    insertionSortRange(vec.begin(), vec.end());
 }
 
 // ***********************************************************************
@@ -90,54 +332,127 @@ void Sorting::insertionSort(std::vector<T>& vec) {
 // ***********************************************************************
 //
 // ** Time Complexity: **
-//  - Worst Case: O(n^2)     (Occurs when all elements are placed in the same bucket, and sorting within each bucket takes O(n) time)
-//  - Best Case: O(n+k)       (Occurs when elements are uniformly distributed and each bucket has a small number of elements, where k is the number of buckets)
-//  - Average Case: O(n+k)    (Average case assuming uniform distribution of input data)
+//  - Worst Case: O(n log n)  (A bucket holding most of the input is merge sorted)
+//  - Best Case: O(n log k)   (Keys spread evenly over k buckets, each small enough 
+//                             for the insertion sort base case)
+//  - Average Case: O(n log n) with a small constant: log2(k) branch-free comparisons 
+//                             to classify an element, then a sort of n / k elements
 //
 // ** Space Complexity: **
-//  - O(n+k)                 (Requires space for the buckets and the output array)
+//  - O(n + k)                (One n-element buffer plus the bucket boundaries and 
+//                             the sample the splitters are drawn from)
 //
 // ** Stability: **
-//  - Stable                 (If stable sorting algorithms are used to sort individual buckets)
+//  - Stable                  (The scatter keeps input order and buckets are merge sorted)
 //
 // ** Characteristics: **
-//  - Distribution-based sorting algorithm
-//  - Divides the input into several buckets, sorts each bucket individually, and then concatenates the buckets to produce the sorted list
-//  - Efficient for data sets that are uniformly distributed over a range
-//  - Often used for sorting floating-point numbers or integers within a specific range
-//  - Can be used in parallel for improved performance on large data sets
+//  - Distribution-based sorting algorithm (a sample sort)
+//  - Divides the input into k buckets, sorts each bucket individually, and the buckets 
+//    are already in order relative to each other
+//  - The k - 1 bucket boundaries (splitters) are evenly spaced quantiles of a sample of 
+//    bucketSortOversampling * k elements, so skewed data still spreads evenly
+//  - Splitters are stored as an implicit binary search tree (children of node i are 
+//    2i and 2i + 1), which classifies an element with log2(k) branch-free steps
+//  - A counting pass sizes every bucket, then a scatter pass moves each element into its 
+//    slot of one contiguous buffer; there are no per-bucket containers
+//  - Each bucket is merge sorted from the buffer straight back into the input, which 
+//    doubles as the merge scratch space; with more than one thread the buckets are 
+//    sorted in parallel
+//  - Only needs operator<, so it works for floating-point values, strings and records
 //
 // ** Invariant: **
-//  - At the start of each iteration, the list is divided into several buckets based on the range of values.
-//  - Each bucket is sorted individually using a different sorting algorithm (often Insertion Sort or Quick Sort).
-//  - After all buckets are sorted, the elements from the buckets are concatenated in order to form the final sorted list.
-//  - The final result maintains the relative order of elements within each bucket if the sorting algorithm used within the bucket is stable.
+//  - Every key in bucket i is >= splitter i - 1 and < splitter i, so all keys of a 
+//    bucket precede all keys of the following buckets.
+//  - After the scatter, bucket i occupies the buffer slots [start(i), start(i + 1)) 
+//    and keeps the input order of its elements.
+//  - After every bucket is sorted into the input, the whole input is sorted.
 //
 // ***********************************************************************
 
+template <typename Instrumentation>
 template <typename T>
-void Sorting::bucketSort(std::vector<T>& vec) {
+void BasicSorting<Instrumentation>::bucketSort(std::vector<T>& vec) {
+    InstrumentedCall call{instrumentation};
     size_t size{vec.size()};
-    if (size <= 1) return;
-
-    T minValue = *std::min_element(vec.begin(), vec.end());
-    T maxValue = *std::max_element(vec.begin(), vec.end());
+    if (size <= mergeSortRunLength) {
+        insertionSortRange(vec.begin(), vec.end());
+        return;
+    }
 
-    std::vector<std::vector<T>> buckets(size);
+    // Splitters: evenly spaced quantiles of a sorted sample, laid out as an implicit 
+    // search tree where node i has children 2i and 2i + 1 and the root is node 1.
+    size_t bucketCount{std::bit_floor(std::clamp(size / bucketSortTargetSize, size_t{2}, maxBucketCount))};
+    size_t sampleSize{std::min(size, bucketCount * bucketSortOversampling)};
+    std::vector<T> sample(sampleSize);
+    std::uint64_t state{0x9E3779B97F4A7C15ull};
+    for (size_t i{}; i < sampleSize; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        sample[i] = vec[state % size];
+    }
+    introSortLoop<T>(nullptr, nullptr, sample, 0, 0, sampleSize, 2 * static_cast<size_t>(std::bit_width(sampleSize)), 0);
+    std::vector<T> splitters(bucketCount);
+    for (size_t node{1}; node < bucketCount; ++node) {
+        size_t level{static_cast<size_t>(std::bit_width(node)) - 1};
+        size_t rank{(2 * (node - (size_t{1} << level)) + 1) * (bucketCount >> (level + 1))};
+        splitters[node] = sample[rank * sampleSize / bucketCount];
+    }
+    auto bucketOf = [&](const T& value) {
+        size_t node{1};
+        while (node < bucketCount) {
+            node = 2 * node + static_cast<size_t>(!less(value, splitters[node]));
+        }
+        return node - bucketCount;
+    };
 
-    for (size_t i{}; i < size; ++i) {
-        size_t bucketIndex{(vec[i] - minValue) * (size - 1) / (maxValue - minValue)};
-        buckets[bucketIndex].push_back(vec[i]);
+    std::vector<size_t> bucketStarts(bucketCount + 1, 0);
+    {
+        [[maybe_unused]] auto phase{instrumentation.phase(SortPhase::histogram)};
+        for (size_t i{}; i < size; ++i) {
+            ++bucketStarts[bucketOf(vec[i]) + 1];
+        }
+        for (size_t bucket{1}; bucket <= bucketCount; ++bucket) {
+            bucketStarts[bucket] += bucketStarts[bucket - 1];
+        }
     }
 
-    for (size_t i{}; i < size; ++i) {
-        insertionSort(buckets[i]);
+    std::unique_ptr<T[]> buffer{std::make_unique_for_overwrite<T[]>(size)};
+    instrumentation.countAllocation(size * sizeof(T) + (sampleSize + bucketCount) * sizeof(T) 
+                                    + (2 * bucketCount + 1) * sizeof(size_t));
+    {
+        [[maybe_unused]] auto phase{instrumentation.phase(SortPhase::scatter)};
+        std::vector<size_t> next(bucketStarts.begin(), bucketStarts.end() - 1);
+        for (size_t i{}; i < size; ++i) {
+            buffer[next[bucketOf(vec[i])]++] = std::move(vec[i]);
+        }
+        instrumentation.countMoves(size);
     }
 
-    size_t index{};
-    for (size_t i{}; i < size; ++i) {
-        for (size_t j{}; j < buckets[i].size(); ++j) {
-            vec[index++] = buckets[i][j];
+    // Each bucket is merge sorted out of the buffer into its final place in vec.
+    unsigned threads{resolvedThreadCount()};
+    if (threads > 1 && size >= 2 * parallelGrain) {
+        TaskGroup group;
+        TaskPool pool{threads};
+        GroupJoin join{pool, group};
+        size_t batchStart{};
+        for (size_t bucket{1}; bucket <= bucketCount; ++bucket) {
+            size_t first{bucketStarts[batchStart]};
+            size_t last{bucketStarts[bucket]};
+            if (last - first >= parallelGrain || bucket == bucketCount) {
+                pool.run(group, [=, this, &pool, &bucketStarts, &buffer, &vec] {
+                    for (size_t i{batchStart}; i < bucket; ++i) {
+                        mergeSortRange(&pool, buffer.get(), vec.data(), bucketStarts[i], bucketStarts[i + 1], false, 1);
+                    }
+                });
+                batchStart = bucket;
+            }
+        }
+        pool.wait(group);
+    }
+    else {
+        for (size_t bucket{}; bucket < bucketCount; ++bucket) {
+            mergeSortRange<T>(nullptr, buffer.get(), vec.data(), bucketStarts[bucket], bucketStarts[bucket + 1], false, 1);
         }
     }
 }
@@ -152,7 +467,8 @@ void Sorting::bucketSort(std::vector<T>& vec) {
 //  - Average Case: O(n+k)    (As the algorithm always processes the input and the range)
 //
 // ** Space Complexity: **
-//  - O(k)                   (Requires space for the counting array based on the range of input values)
+//  - O(n + k)               (Requires space for the counting array based on the range of input values; 
+//                            k never exceeds max(n, countingSortRangeLimit))
 //
 // ** Stability: **
 //  - Stable                 (Preserves the relative order of equal elements)
@@ -162,7 +478,10 @@ void Sorting::bucketSort(std::vector<T>& vec) {
 //  - Assumes that input values are integers within a specific range
 //  - Works by counting the occurrences of each element in the input and using those counts to place the elements in the correct position
 //  - Efficient for sorting data with a limited range of values, especially when the range is not significantly larger than the number of elements
-//  - Can be used for integer sorting and sorting certain non-negative types like integers or characters
+//  - Works for every integer type, including negative values; the range is computed on 
+//    the radixKey() of each value, so it cannot overflow
+//  - Falls back to Radix Sort when the range k is at least max(n, countingSortRangeLimit), 
+//    and for non-integer types, so a single outlier key cannot blow up memory
 //
 // ** Invariant: **
 //  - At the start of the algorithm, a counting array is initialized to store the frequency of each value in the input.
@@ -172,30 +491,250 @@ void Sorting::bucketSort(std::vector<T>& vec) {
 //
 // ***********************************************************************
 
+template <typename Instrumentation>
 template <typename T>
-void Sorting::countingSort(std::vector<T>& vec) {
+void BasicSorting<Instrumentation>::countingSort(std::vector<T>& vec) {
+    InstrumentedCall call{instrumentation};
     size_t size{vec.size()};
-    std::vector<T> tmp(size);
-    T max = *std::max_element(vec.begin(), vec.end());
-    T min = *std::min_element(vec.begin(), vec.end());
-    if (min == max) {
-        std::cout << "Vec is already sorted.\n";
+    if (size < 2) {
         return;
     }
-    int shift{-min};
-    size_t range = max - min + 1;
-    std::vector<size_t> count(range, 0);
-    for (size_t i{}; i < size; ++i) {
-        ++count[vec[i] + shift];
+    if constexpr (!std::is_integral_v<T> || std::is_same_v<T, bool>) {
+        radixSort(vec);
+    }
+    else {
+        auto [minIt, maxIt] = std::minmax_element(vec.begin(), vec.end());
+        auto minKey{radixKey(*minIt)};
+        size_t range{static_cast<size_t>(radixKey(*maxIt) - minKey)};
+        if (range == 0) {
+            return;
+        }
+        // A wide key range would need a huge count array; radix sort keeps 
+        // memory at O(n) whatever the keys are.
+        if (range >= std::max(size, countingSortRangeLimit)) {
+            radixSort(vec);
+            return;
+        }
+
+        std::vector<size_t> count(range + 1, 0);
+        std::vector<T> tmp(size);
+        instrumentation.countAllocation((range + 1) * sizeof(size_t) + size * sizeof(T));
+        {
+            [[maybe_unused]] auto phase{instrumentation.phase(SortPhase::histogram)};
+            for (size_t i{}; i < size; ++i) {
+                ++count[radixKey(vec[i]) - minKey];
+            }
+            for (size_t i{1}; i <= range; ++i) {
+                count[i] += count[i - 1];
+            }
+        }
+        [[maybe_unused]] auto phase{instrumentation.phase(SortPhase::scatter)};
+        for (size_t i{size}; i-- > 0;) {
+            tmp[--count[radixKey(vec[i]) - minKey]] = vec[i];
+        }
+        std::copy(tmp.begin(), tmp.end(), vec.begin());
+        instrumentation.countMoves(2 * size);
+    }
+}
+
+// ***********************************************************************
+//                            Radix Sort Algorithm
+// ***********************************************************************
+//
+// ** Time Complexity: **
+//  - Worst Case: O(d * (n + 2^b))  (d digits of b bits each: 8 bits for keys narrower 
+//                                   than 32 bits, 11 bits otherwise; for strings d is 
+//                                   the length of the longest common prefix)
+//  - Best Case: O(n)               (Digits shared by every key are skipped)
+//  - Average Case: O(d * (n + 2^b))
+//
+// ** Space Complexity: **
+//  - O(n + d * 2^b)         (LSD: one scratch buffer plus one histogram per digit)
+//  - O(2^8 + buckets)       (MSD on strings: in place, only bucket bookkeeping)
+//
+// ** Stability: **
+//  - Stable                 (LSD on numbers; equal strings are indistinguishable)
+//
+// ** Characteristics: **
+//  - Non-comparison-based sorting algorithm
+//  - Numbers (every signed and unsigned integer up to 64 bits, float and double) are 
+//    mapped to unsigned keys with the same order by radixKey(): the sign bit of signed 
+//    integers is flipped, negative floating-point values have all bits inverted and 
+//    non-negative ones get their sign bit set.
+//  - LSD (least significant digit first): the histograms of all digits are computed in 
+//    a single pass over the input, then each digit is scattered between the input and 
+//    one scratch buffer. A digit on which every key agrees is skipped entirely.
+//  - MSD (most significant digit first) for std::string: an in-place American flag 
+//    sort on the byte at the current depth, where strings that end at that depth go 
+//    first. Buckets of at most stringInsertionThreshold strings are finished with 
+//    Insertion Sort on their remaining suffixes. Work is kept on an explicit list, so 
+//    long common prefixes cannot overflow the call stack.
+//  - Memory never depends on the range of the key values.
+//
+// ** Invariant: **
+//  - LSD: after processing digit i, the keys are sorted by their lowest i + 1 digits, 
+//    and keys that agree on those digits keep their original relative order.
+//  - MSD: every pending range holds strings that share their first `depth` bytes, and 
+//    the ranges are in their final order relative to each other.
+//
+// ***********************************************************************
+
+template <typename Instrumentation>
+template <typename T>
+auto BasicSorting<Instrumentation>::radixKey(T value) {
+    if constexpr (std::is_floating_point_v<T>) {
+        using Bits = std::conditional_t<sizeof(T) == sizeof(std::uint32_t), std::uint32_t, std::uint64_t>;
+        constexpr Bits signBit{Bits{1} << (sizeof(Bits) * 8 - 1)};
+        Bits bits{std::bit_cast<Bits>(value)};
+        return static_cast<Bits>((bits & signBit) ? ~bits : (bits | signBit));
+    }
+    else {
+        using Bits = std::make_unsigned_t<T>;
+        Bits bits{static_cast<Bits>(value)};
+        if constexpr (std::is_signed_v<T>) {
+            bits = static_cast<Bits>(bits ^ (Bits{1} << (sizeof(Bits) * 8 - 1)));
+        }
+        return bits;
+    }
+}
+
+template <typename Instrumentation>
+template <typename T>
+void BasicSorting<Instrumentation>::radixSort(std::vector<T>& vec) {
+    InstrumentedCall call{instrumentation};
+    static_assert((std::is_integral_v<T> && !std::is_same_v<T, bool>) 
+                  || std::is_same_v<T, float> || std::is_same_v<T, double>,
+                  "radixSort supports integers, float, double and std::string");
+    using Key = decltype(radixKey(std::declval<T>()));
+    constexpr unsigned keyBits{sizeof(Key) * 8};
+    constexpr unsigned digitBits{keyBits >= 32 ? 11u : 8u};
+    constexpr unsigned digitCount{(keyBits + digitBits - 1) / digitBits};
+    constexpr size_t bucketCount{size_t{1} << digitBits};
+
+    size_t size{vec.size()};
+    if (size < 2) {
+        return;
+    }
+
+    std::vector<size_t> histograms(digitCount * bucketCount, 0);
+    {
+        [[maybe_unused]] auto phase{instrumentation.phase(SortPhase::histogram)};
+        for (size_t i{}; i < size; ++i) {
+            Key key{radixKey(vec[i])};
+            for (unsigned digit{}; digit < digitCount; ++digit) {
+                ++histograms[digit * bucketCount + ((key >> (digit * digitBits)) & (bucketCount - 1))];
+            }
+        }
+    }
+
+    std::unique_ptr<T[]> scratch{std::make_unique_for_overwrite<T[]>(size)};
+    instrumentation.countAllocation(histograms.size() * sizeof(size_t) + size * sizeof(T));
+    [[maybe_unused]] auto phase{instrumentation.phase(SortPhase::scatter)};
+    T* from{vec.data()};
+    T* to{scratch.get()};
+    for (unsigned digit{}; digit < digitCount; ++digit) {
+        unsigned shift{digit * digitBits};
+        size_t* offsets{histograms.data() + digit * bucketCount};
+        if (offsets[(radixKey(from[0]) >> shift) & (bucketCount - 1)] == size) {
+            continue;
+        }
+
+        size_t total{};
+        for (size_t bucket{}; bucket < bucketCount; ++bucket) {
+            size_t count{offsets[bucket]};
+            offsets[bucket] = total;
+            total += count;
+        }
+        for (size_t i{}; i < size; ++i) {
+            to[offsets[(radixKey(from[i]) >> shift) & (bucketCount - 1)]++] = from[i];
+        }
+        instrumentation.countMoves(size);
+        std::swap(from, to);
     }
-    for (size_t i{1}; i < range; ++i) {
-        count[i] += count[i - 1]; 
+    if (from != vec.data()) {
+        std::copy(from, from + size, vec.data());
+        instrumentation.countMoves(size);
     }
-    for (int i = size - 1; i >= 0; --i) {
-        tmp[--count[vec[i] + shift]] = vec[i];
+}
+
+template <typename Instrumentation>
+void BasicSorting<Instrumentation>::radixSort(std::vector<std::string>& vec) {
+    InstrumentedCall call{instrumentation};
+    // Bucket 0 holds strings that end at the current depth, bucket c + 1 holds byte c.
+    constexpr size_t bucketCount{257};
+    auto bucketOf = [](const std::string& str, size_t depth) -> size_t {
+        return depth < str.size() ? static_cast<unsigned char>(str[depth]) + size_t{1} : 0;
+    };
+
+    struct Range {
+        size_t first;
+        size_t last;
+        size_t depth;
+    };
+    std::vector<Range> pending;
+    if (vec.size() > 1) {
+        pending.push_back({0, vec.size(), 0});
     }
-    for (int i{}; i < size; ++i) {
-        vec[i] = tmp[i];
+    std::array<size_t, bucketCount> counts;
+    std::array<size_t, bucketCount> next;
+    std::array<size_t, bucketCount> ends;
+
+    while (!pending.empty()) {
+        auto [first, last, depth] = pending.back();
+        pending.pop_back();
+        instrumentation.recordDepth(depth);
+
+        if (last - first <= stringInsertionThreshold) {
+            [[maybe_unused]] auto phase{instrumentation.phase(SortPhase::insertion)};
+            for (size_t i{first + 1}; i < last; ++i) {
+                std::string key{std::move(vec[i])};
+                std::string_view keySuffix{std::string_view{key}.substr(depth)};
+                size_t j{i};
+                while (j > first && less(keySuffix, std::string_view{vec[j - 1]}.substr(depth))) {
+                    vec[j] = std::move(vec[j - 1]);
+                    --j;
+                }
+                vec[j] = std::move(key);
+                instrumentation.countMoves(i - j + 2);
+            }
+            continue;
+        }
+
+        [[maybe_unused]] auto phase{instrumentation.phase(SortPhase::scatter)};
+        counts.fill(0);
+        for (size_t i{first}; i < last; ++i) {
+            ++counts[bucketOf(vec[i], depth)];
+        }
+        if (counts[0] == last - first) {
+            continue;
+        }
+        if (counts[bucketOf(vec[first], depth)] == last - first) {
+            pending.push_back({first, last, depth + 1});
+            continue;
+        }
+
+        size_t offset{first};
+        for (size_t bucket{}; bucket < bucketCount; ++bucket) {
+            next[bucket] = offset;
+            offset += counts[bucket];
+            ends[bucket] = offset;
+        }
+        for (size_t bucket{}; bucket < bucketCount; ++bucket) {
+            while (next[bucket] < ends[bucket]) {
+                size_t target{bucketOf(vec[next[bucket]], depth)};
+                if (target == bucket) {
+                    ++next[bucket];
+                }
+                else {
+                    swapElements(vec[next[bucket]], vec[next[target]++]);
+                }
+            }
+        }
+        for (size_t bucket{1}; bucket < bucketCount; ++bucket) {
+            if (counts[bucket] > 1) {
+                pending.push_back({ends[bucket] - counts[bucket], ends[bucket], depth + 1});
+            }
+        }
     }
 }
 
@@ -220,16 +759,20 @@ void Sorting::countingSort(std::vector<T>& vec) {
 //  - Comparison-based sorting algorithm
 //  - A variation of selection sort that repeatedly selects the largest element 
 //    from the unsorted part of the array and swaps it with the root of the heap.
-//  - Builds a binary heap (max-heap or min-heap) and uses this structure to 
-//    efficiently extract the maximum (or minimum) element.
-//  - Works by repeatedly heapifying the input to maintain the heap property.
+//  - Builds a max-heap and uses this structure to efficiently extract the maximum element.
+//  - The heap is heapArity-ary (4 children per node) rather than binary: it is half 
+//    as deep, and the children of a node are adjacent, so they share one or two cache lines.
+//  - Sifting is bottom-up and iterative: the hole left by the sifted value follows the 
+//    largest children down to a leaf, then the value climbs back up to its place. A value 
+//    taken from the end of the heap usually belongs near the leaves, so it climbs only 
+//    a step or two, which saves most of the comparisons of a top-down sift.
 //  - It’s an in-place sorting algorithm with a guaranteed time complexity of O(n log n), 
 //    making it efficient for large datasets.
 //
 // ** Invariant: **
 //  - At the start of the algorithm, the input array is converted into a heap. 
-//    A heap is a complete binary tree where the parent node is greater than 
-//    (in max-heap) or less than (in min-heap) the values of its child nodes.
+//    A max-heap is a complete heapArity-ary tree where every parent is not less 
+//    than any of its children.
 //  - The heap property is maintained after each insertion and removal of elements, 
 //    ensuring that the largest element is always at the root in a max-heap.
 //  - In each iteration of the sorting process, the largest element is moved to the end 
@@ -239,38 +782,79 @@ void Sorting::countingSort(std::vector<T>& vec) {
 //
 // ***********************************************************************
 
+template <typename Instrumentation>
 template <typename T>
-void Sorting::heapify(std::vector<T>& vec, int n, int i) {
-    int largest{i};
-    int left{2 * i + 1};
-    int right{2 * i + 2};
-
-    if (left < n && vec[left] > vec[largest]) {
-        largest = left;
+void BasicSorting<Instrumentation>::heapify(std::vector<T>& vec, size_t first, size_t n, size_t i) {
+    // Bottom-up sift of vec[first + i] in the heap stored in vec[first, first + n).
+    T* heap{vec.data() + first};
+    T value{std::move(heap[i])};
+    size_t hole{i};
+    size_t moves{2};
+    while (true) {
+        size_t child{heapArity * hole + 1};
+        if (child >= n) {
+            break;
+        }
+        size_t childEnd{std::min(child + heapArity, n)};
+        size_t largest{child};
+        for (size_t next{child + 1}; next < childEnd; ++next) {
+            if (less(heap[largest], heap[next])) {
+                largest = next;
+            }
+        }
+        heap[hole] = std::move(heap[largest]);
+        hole = largest;
+        ++moves;
     }
-
-    if (right < n && vec[right] > vec[largest]) {
-        largest = right;
+    while (hole > i) {
+        size_t parent{(hole - 1) / heapArity};
+        if (!less(heap[parent], value)) {
+            break;
+        }
+        heap[hole] = std::move(heap[parent]);
+        hole = parent;
+        ++moves;
     }
+    heap[hole] = std::move(value);
+    instrumentation.countMoves(moves);
+}
 
-    if (largest != i) {
-        std::swap(vec[i], vec[largest]);
-        heapify(vec, n, largest);
+template <typename Instrumentation>
+template <typename T>
+void BasicSorting<Instrumentation>::makeHeap(std::vector<T>& vec, size_t first, size_t size) {
+    if (size < 2) {
+        return;
+    }
+    [[maybe_unused]] auto phase{instrumentation.phase(SortPhase::heapify)};
+    for (size_t i{(size - 2) / heapArity + 1}; i-- > 0;) {
+        heapify(vec, first, size, i);
     }
 }
 
+template <typename Instrumentation>
 template <typename T>
-void Sorting::heapSort(std::vector<T>& vec) {
-    size_t size{vec.size()};
-    for (int i = size / 2 - 1; i >= 0; --i) {
-        heapify(vec, size, i);
-    }
-    for (size_t i{size - 1}; i > 0; --i) {
-        std::swap(vec[0], vec[i]);
-        heapify(vec, i, 0);
+void BasicSorting<Instrumentation>::sortHeap(std::vector<T>& vec, size_t first, size_t size) {
+    [[maybe_unused]] auto phase{instrumentation.phase(SortPhase::heapify)};
+    for (size_t i{size}; i-- > 1;) {
+        swapElements(vec[first], vec[first + i]);
+        heapify(vec, first, i, 0);
     }
 }
 
+template <typename Instrumentation>
+template <typename T>
+void BasicSorting<Instrumentation>::heapSortRange(std::vector<T>& vec, size_t first, size_t last) {
+    makeHeap(vec, first, last - first);
+    sortHeap(vec, first, last - first);
+}
+
+template <typename Instrumentation>
+template <typename T>
+void BasicSorting<Instrumentation>::heapSort(std::vector<T>& vec) {
+    InstrumentedCall call{instrumentation};
+    heapSortRange(vec, 0, vec.size());
+}
+
 // ***********************************************************************
 //                            Merge Sort Algorithm
 // ***********************************************************************
@@ -282,10 +866,11 @@ void Sorting::heapSort(std::vector<T>& vec) {
 //                               the list in half and merges it)
 //  - Average Case: O(n log n)  (Divide and conquer approach, consistently 
 //                               takes O(n log n) time)
+//  - Parallel: O(n log n / p + log^2 n) with p threads (both the recursive halves 
+//                               and every large merge are split across the pool)
 //
 // ** Space Complexity: **
-//  - O(n)                      (Requires extra space to store temporary arrays 
-//                               during the merge process)
+//  - O(n)                      (One scratch buffer allocated once per sort call)
 //
 // ** Stability: **
 //  - Stable                    (Does not change the relative order of equal elements)
@@ -297,159 +882,1082 @@ void Sorting::heapSort(std::vector<T>& vec) {
 //    them back together in sorted order.
 //  - The merging process ensures that the two halves are combined in sorted 
 //    order by comparing the elements from each half in turn and placing the 
-//    smaller element into the original array.
-//  - Efficient for large datasets but requires additional space for temporary arrays.
+//    smaller element first; on ties the left element wins, which keeps the sort stable.
+//  - The input and the scratch buffer are used in ping-pong fashion: each level sorts 
+//    its halves into the other array and merges them back, so nothing is copied back 
+//    after a merge.
+//  - Runs of at most mergeSortRunLength elements are sorted with Insertion Sort.
+//  - For std::int32_t and std::int64_t keys on CPUs with AVX2 or AVX-512 (see 
+//    sortingAlgorithmsSimd.tpp), runs are sorted by a bitonic sorting network and 
+//    merges advance one register at a time through a bitonic merge network, unless 
+//    a large merge barely interleaves its runs. Equal integers are indistinguishable, 
+//    so the sort stays stable; floating-point keys keep the scalar code because +0.0 
+//    and -0.0 compare equal.
+//  - Halves that are already in order (or in reverse order) are concatenated after a 
+//    single comparison, so presorted input costs one pass per level.
+//  - With more than one thread (see setThreadCount()) the left half is handed to the 
+//    work-stealing pool and large merges are cut into independent pieces: the split 
+//    point of each output position (its co-rank) is found by binary search.
 //  - Works well for sorting linked lists as well, and is stable (maintains the 
 //    relative order of equal elements).
 //
 // ** Invariant: **
-//  - The array is recursively divided into halves until sub-arrays of size 1 are reached, 
-//    which are inherently sorted.
+//  - The array is recursively divided into halves until runs of at most 
+//    mergeSortRunLength elements are reached, which are sorted directly.
 //  - During the merging phase, two sorted sub-arrays (left and right) are combined in 
-//    sorted order by comparing their elements and inserting them back into the original 
-//    array. The merging process continues until the entire array is sorted.
+//    sorted order by comparing their elements and writing them into the other array. 
+//    The merging process continues until the entire array is sorted.
 //  - After all recursive calls, the original array is sorted in ascending order.
 //
 // ***********************************************************************
 
+template <typename Instrumentation>
 template <typename T>
-void Sorting::merge(std::vector<T>& vec, size_t left, size_t mid, size_t right) {
-    size_t leftSize{mid - left + 1};
-    size_t rightSize{right - mid};
-    std::vector<T> L(leftSize);
-    std::vector<T> R(rightSize);
-
-    for (size_t i{}; i < leftSize; ++i) {
-        L[i] = vec[left + i];
+void BasicSorting<Instrumentation>::merge(T* left, size_t leftSize, T* right, size_t rightSize, T* out) {
+    [[maybe_unused]] auto phase{instrumentation.phase(SortPhase::merge)};
+    instrumentation.countMoves(leftSize + rightSize);
+    // Runs already in order are concatenated, and runs in reverse order swap places, 
+    // after a single comparison.
+    if (leftSize == 0 || rightSize == 0 || !less(right[0], left[leftSize - 1])) {
+        std::move(right, right + rightSize, std::move(left, left + leftSize, out));
+        return;
     }
-
-    for (size_t i{}; i < rightSize; ++i) {
-        R[i] = vec[mid + 1 + i];
+    if (less(right[rightSize - 1], left[0])) {
+        std::move(left, left + leftSize, std::move(right, right + rightSize, out));
+        return;
+    }
+    size_t i{}, j{}, k{};
+    if constexpr (vectorized<T, true>) {
+        // Merges of fewer than mergeVectorProbeSize elements go to the merge kernel. 
+        // Larger ones run scalar, whose branch predicts well while one run keeps 
+        // winning, as in nearly sorted input, in windows of mergeVectorWindow outputs; 
+        // after a window that changed sides at least mergeVectorSwitches times the 
+        // kernel merges the next mergeVectorBlock elements of the left run.
+        if (leftSize + rightSize < mergeVectorProbeSize 
+            && sortingDetail::simd::merge(left, leftSize, right, rightSize, out)) {
+            return;
+        }
+        bool fromRight{};
+        while (sortingDetail::simd::registerWidth<T>() > 0 && i < leftSize && j < rightSize) {
+            size_t switches{};
+            for (size_t windowEnd{k + mergeVectorWindow}; k < windowEnd && i < leftSize && j < rightSize;) {
+                bool takeRight{less(right[j], left[i])};
+                switches += takeRight != fromRight;
+                fromRight = takeRight;
+                if (takeRight) {
+                    out[k++] = std::move(right[j++]);
+                }
+                else {
+                    out[k++] = std::move(left[i++]);
+                }
+            }
+            if (switches >= mergeVectorSwitches && i < leftSize && j < rightSize) {
+                // The block of the left run and the right elements that precede its 
+                // last one, so ties still go to the left run.
+                size_t fromLeft{std::min(leftSize - i, mergeVectorBlock)};
+                T* rightBlockEnd{std::lower_bound(right + j, right + rightSize, left[i + fromLeft - 1], 
+                                                  [&](const T& a, const T& b) { return less(a, b); })};
+                size_t fromRight{static_cast<size_t>(rightBlockEnd - (right + j))};
+                if (sortingDetail::simd::merge(left + i, fromLeft, right + j, fromRight, out + k)) {
+                    i += fromLeft;
+                    j += fromRight;
+                    k += fromLeft + fromRight;
+                }
+            }
+        }
     }
-   
-    size_t i{}, j{}, k{left};
     while (i < leftSize && j < rightSize) {
-        if (L[i] < R[j]) {
-            vec[k] = L[i];
-            ++i;
+        if (less(right[j], left[i])) {
+            out[k++] = std::move(right[j++]);
+        }
+        else {
+            out[k++] = std::move(left[i++]);
+        }
+    }
+    out = std::move(left + i, left + leftSize, out + k);
+    std::move(right + j, right + rightSize, out);
+}
+
+template <typename Instrumentation>
+template <typename T>
+size_t BasicSorting<Instrumentation>::coRank(size_t k, const T* left, size_t leftSize, const T* right, size_t rightSize) {
+    // Number of elements taken from `left` among the first k outputs of a 
+    // stable merge of left and right.
+    size_t low{k > rightSize ? k - rightSize : 0};
+    size_t high{std::min(k, leftSize)};
+    while (low < high) {
+        size_t i{low + (high - low) / 2};
+        size_t j{k - i};
+        if (j > 0 && !less(right[j - 1], left[i])) {
+            low = i + 1;
         }
         else {
-            vec[k] = R[j];
-            ++j;
+            high = i;
+        }
+    }
+    return low;
+}
+
+template <typename Instrumentation>
+template <typename T>
+void BasicSorting<Instrumentation>::parallelMerge(TaskPool* pool, T* left, size_t leftSize, T* right, size_t rightSize, T* out) {
+    size_t total{leftSize + rightSize};
+    if (pool == nullptr || total < 2 * parallelGrain) {
+        merge(left, leftSize, right, rightSize, out);
+        return;
+    }
+
+    // All split points are found before any piece starts, because merging moves 
+    // elements out of the runs that the binary searches read.
+    size_t pieces{std::min(total / parallelGrain, 4 * pool->size())};
+    std::vector<size_t> leftSplits(pieces + 1);
+    instrumentation.countAllocation(leftSplits.size() * sizeof(size_t));
+    for (size_t piece{}; piece <= pieces; ++piece) {
+        leftSplits[piece] = coRank(total * piece / pieces, left, leftSize, right, rightSize);
+    }
+    auto mergePiece = [=, this, &leftSplits](size_t piece) {
+        size_t begin{total * piece / pieces};
+        size_t end{total * (piece + 1) / pieces};
+        size_t leftBegin{leftSplits[piece]};
+        size_t leftEnd{leftSplits[piece + 1]};
+        merge(left + leftBegin, leftEnd - leftBegin, 
+              right + (begin - leftBegin), (end - leftEnd) - (begin - leftBegin), out + begin);
+    };
+
+    TaskGroup group;
+    GroupJoin join{*pool, group};
+    for (size_t piece{1}; piece < pieces; ++piece) {
+        pool->run(group, [=] { mergePiece(piece); });
+    }
+    mergePiece(0);
+    pool->wait(group);
+}
+
+template <typename Instrumentation>
+template <typename T>
+void BasicSorting<Instrumentation>::mergeSortRange(TaskPool* pool, T* data, T* scratch, size_t first, size_t last, 
+                                                   bool intoData, size_t depth) {
+    instrumentation.recordDepth(depth);
+    size_t size{last - first};
+    if (size <= mergeSortRunLength) {
+        sortSmallRange<true>(data + first, data + last);
+        if (!intoData) {
+            std::move(data + first, data + last, scratch + first);
+            instrumentation.countMoves(size);
         }
-        ++k;
+        return;
     }
 
-    while (i < leftSize) {
-        vec[k++] = L[i++];
+    size_t mid{first + size / 2};
+    if (pool != nullptr && size >= parallelGrain) {
+        TaskGroup group;
+        GroupJoin join{*pool, group};
+        pool->run(group, [=, this] { mergeSortRange(pool, data, scratch, first, mid, !intoData, depth + 1); });
+        mergeSortRange(pool, data, scratch, mid, last, !intoData, depth + 1);
+        pool->wait(group);
     }
-    while (j < rightSize) {
-        vec[k++] = R[j++];
+    else {
+        mergeSortRange(pool, data, scratch, first, mid, !intoData, depth + 1);
+        mergeSortRange(pool, data, scratch, mid, last, !intoData, depth + 1);
     }
+
+    T* from{intoData ? scratch : data};
+    T* to{intoData ? data : scratch};
+    parallelMerge(pool, from + first, mid - first, from + mid, last - mid, to + first);
 }
  
+template <typename Instrumentation>
 template <typename T>
-void Sorting::mergeSort(std::vector<T>& vec, size_t left, size_t right) {
-    if (left < right) {
-        size_t mid{left + (right - left) / 2};
-        mergeSort(vec, left, mid);
-        mergeSort(vec, mid + 1, right);
-        merge(vec, left, mid, right);
+void BasicSorting<Instrumentation>::mergeSort(std::vector<T>& vec, size_t left, size_t right) {
+    InstrumentedCall call{instrumentation};
+    if (vec.empty() || left >= right) {
+        return;
+    }
+    size_t size{right - left + 1};
+    std::unique_ptr<T[]> scratch{std::make_unique_for_overwrite<T[]>(size)};
+    instrumentation.countAllocation(size * sizeof(T));
+    unsigned threads{resolvedThreadCount()};
+    if (threads > 1 && size >= 2 * parallelGrain) {
+        TaskPool pool{threads};
+        mergeSortRange(&pool, vec.data() + left, scratch.get(), 0, size, true, 0);
+    }
+    else {
+        mergeSortRange<T>(nullptr, vec.data() + left, scratch.get(), 0, size, true, 0);
     }
 }
 
 // ***********************************************************************
-//                            Quick Sort Algorithm
+//                            Power Sort Algorithm
 // ***********************************************************************
 //
 // ** Time Complexity: **
-//  - Worst Case: O(n^2)     (Occurs when the pivot is the smallest or largest 
-//                            element in the array, resulting in unbalanced partitions)
-//  - Best Case: O(n log n)  (Occurs when the pivot divides the array into 
-//                            nearly equal halves)
-//  - Average Case: O(n log n) (Occurs in most cases when the pivot divides 
-//                            the array into reasonably balanced parts)
+//  - Worst Case: O(n log n)    (Random input: every run is powerSortMinRun long)
+//  - Best Case: O(n)           (Input that is already sorted, or sorted in reverse, 
+//                               is a single run)
+//  - Adaptive: O(n + n H), where H = sum of (r_i / n) log2(n / r_i) over the lengths 
+//                               r_i of the natural runs; a few runs means little work
 //
 // ** Space Complexity: **
-//  - O(log n)               (Auxiliary space due to recursive call stack)
+//  - O(min(left, right))       (The merge buffer holds the shorter run of the largest 
+//                               merge, at most n / 2 elements, and nothing if the 
+//                               input is one run)
 //
 // ** Stability: **
-//  - Unstable               (May change the relative order of equal elements)
+//  - Stable                    (Only strictly descending runs are reversed, and every 
+//                               merge takes the left element on ties)
 //
 // ** Characteristics: **
-//  - Comparison-based sorting algorithm
-//  - A divide-and-conquer sorting algorithm that works by selecting a "pivot" element 
-//    from the array and partitioning the other elements into two sub-arrays according 
-//    to whether they are less than or greater than the pivot.
-//  - The sub-arrays are then sorted recursively.
-//  - The efficiency of Quick Sort depends heavily on the choice of pivot: 
-//    a good choice results in O(n log n) time complexity, while a poor choice can degrade 
-//    to O(n^2).
-//  - In practice, Quick Sort is one of the fastest sorting algorithms, especially 
-//    for large datasets, and is often used in standard libraries.
-//  - It operates in-place, meaning it doesn't require extra memory except for the 
-//    recursion stack.
-//  - The algorithm is not stable, meaning equal elements might not maintain their 
-//    relative order after sorting.
+//  - Comparison-based, adaptive merge sort in the style of Timsort, with the merge 
+//    order of Powersort (Munro and Wild).
+//  - Scans the input for natural runs: non-descending runs are used as they are, 
+//    strictly descending ones are reversed in place.
+//  - Runs shorter than powerSortMinRun are extended with Binary Insertion Sort, which 
+//    finds each insertion point with O(log r) comparisons.
+//  - Each boundary between two adjacent runs gets a power: the depth at which it would 
+//    split [0, n) in a perfectly balanced merge tree. Runs wait on a stack whose powers 
+//    increase; a new boundary first merges every run above it with a higher power. This 
+//    merge order is within O(n) comparisons of the best possible for the given runs.
+//  - Before a merge, elements already in place at the start of the left run and at the 
+//    end of the right run are skipped by exponential search, and only the shorter of 
+//    the two remaining runs is moved into the buffer.
+//  - While merging, when one side wins initialMinGallop comparisons in a row the merge 
+//    switches to galloping: it finds how many elements in a row each side contributes 
+//    with exponential search and moves them as a block. The threshold falls while 
+//    galloping pays off and rises when it does not.
+//  - For integers in natural order with a vector unit, runs shorter than 
+//    networkMaxSize are extended with the sorting network instead: the missing part 
+//    is sorted and merged into the run found. Merging still starts straight and 
+//    gallops as above, but after powerSortVectorHandOff comparisons without galloping 
+//    the vectorized merge kernel takes blocks of powerSortVectorBlock elements, and 
+//    keeps doing so, across merges, while the blocks interleave evenly.
+//  - compare and projection work like the std::ranges algorithms, e.g. 
+//    powerSort(records, std::greater<>{}, &Record::timestamp).
 //
 // ** Invariant: **
-//  - At the start of each recursion, the pivot element is placed in its correct 
-//    position in the sorted array, with all elements less than the pivot to the 
-//    left and all elements greater than the pivot to the right.
-//  - After partitioning, the pivot is "locked" in its final position, and the sub-arrays 
-//    on either side of the pivot are recursively sorted.
-//  - Once the recursion reaches sub-arrays of size 1 or 0, the sorting is complete.
+//  - The input is covered by the runs on the stack, the current run, and the unscanned 
+//    rest, in that order. Every run is sorted.
+//  - The powers of the run boundaries on the stack increase from bottom to top.
+//  - After the scan, merging the stack from the top leaves a single sorted run.
 //
 // ***********************************************************************
 
-template <typename T>
-int Sorting::partition(std::vector<T>& vec, size_t left, size_t right) {
-    size_t randomIndex = left + rand() % (right - left + 1);
-    std::swap(vec[right], vec[randomIndex]);
-    T pivot{vec[right]};
+template <typename Instrumentation>
+template <typename T, typename Before>
+size_t BasicSorting<Instrumentation>::countRun(T* first, T* last, Before& before) {
+    // Length of the run at first; a strictly descending run is reversed.
+    if (last - first < 2) {
+        return static_cast<size_t>(last - first);
+    }
+    T* end{first + 2};
+    if (before(first[1], first[0])) {
+        while (end < last && before(*end, *(end - 1))) {
+            ++end;
+        }
+        std::reverse(first, end);
+        instrumentation.countMoves(static_cast<size_t>(end - first));
+    }
+    else {
+        while (end < last && !before(*end, *(end - 1))) {
+            ++end;
+        }
+    }
+    return static_cast<size_t>(end - first);
+}
 
-    int i = left - 1;
-    for (size_t j{left}; j < right; ++j) {
-        if (vec[j] < pivot) {
-            ++i;
-            std::swap(vec[i], vec[j]);
+template <typename Instrumentation>
+template <typename T, typename Before>
+void BasicSorting<Instrumentation>::binaryInsertionSort(T* first, T* sortedEnd, T* last, Before& before) {
+    // Inserts [sortedEnd, last) into the sorted prefix [first, sortedEnd), each one 
+    // after any equal elements.
+    [[maybe_unused]] auto phase{instrumentation.phase(SortPhase::insertion)};
+    for (T* next{sortedEnd}; next < last; ++next) {
+        // Branch-free binary search: the insertion point stays in [low, low + count].
+        T* low{first};
+        size_t count{static_cast<size_t>(next - first)};
+        while (count > 1) {
+            size_t half{count / 2};
+            low = before(*next, low[half]) ? low : low + half;
+            count -= half;
+        }
+        if (count == 1 && !before(*next, *low)) {
+            ++low;
+        }
+        if (low != next) {
+            T value{std::move(*next)};
+            std::move_backward(low, next, next + 1);
+            *low = std::move(value);
+            instrumentation.countMoves(static_cast<size_t>(next - low) + 2);
         }
     }
-    std::swap(vec[i + 1], vec[right]);
-    return i + 1;
 }
 
-template <typename T>
-void Sorting::quickSort(std::vector<T>& vec, int left, int right) {
-    if (left < right) {
-        int pivotIndex{partition(vec, left, right)};
-        quickSort(vec, left, pivotIndex - 1);
-        quickSort(vec, pivotIndex + 1, right);
+template <typename Instrumentation>
+template <bool Upper, typename T, typename Before>
+size_t BasicSorting<Instrumentation>::gallop(const T& key, const T* base, size_t size, size_t hint, Before& before) {
+    // Position in base[0, size) where key goes: after every element less than key, and 
+    // with Upper also after the elements equal to it. The search doubles its step 
+    // outward from base[hint], then binary searches the last step, so finding 
+    // position p costs O(log |p - hint|) comparisons.
+    auto goesBefore = [&](size_t i) { return Upper ? !before(key, base[i]) : before(base[i], key); };
+    size_t low{}, high{};
+    if (goesBefore(hint)) {
+        size_t step{1};
+        low = hint + 1;
+        while (hint + step < size && goesBefore(hint + step)) {
+            low = hint + step + 1;
+            step *= 2;
+        }
+        high = std::min(hint + step, size);
+    }
+    else {
+        size_t step{1};
+        high = hint;
+        while (step <= hint && !goesBefore(hint - step)) {
+            high = hint - step;
+            step *= 2;
+        }
+        low = step <= hint ? hint - step + 1 : 0;
+    }
+    while (low < high) {
+        size_t mid{low + (high - low) / 2};
+        if (goesBefore(mid)) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
     }
+    return low;
 }
 
-// ***********************************************************************
-//                            Selection Sort Algorithm
-// ***********************************************************************
-//
-// ** Time Complexity: **
-//  - Worst Case: O(n^2)     (Occurs regardless of the input, as Selection Sort 
-//                            always performs a nested loop to find the minimum element)
-//  - Best Case: O(n^2)      (Even if the array is already sorted, Selection Sort 
-//                            still goes through the entire array)
-//  - Average Case: O(n^2)   (Same as worst case, since it always performs n^2 operations)
-//
-// ** Space Complexity: **
-//  - O(1)                   (In-place sorting, no extra space required for sorting)
-//
-// ** Stability: **
-//  - Unstable               (May change the relative order of equal elements)
-//
-// ** Characteristics: **
-//  - Comparison-based sorting algorithm
-//  - Iteratively selects the smallest element from the unsorted portion of the array
-//    and places it in its correct position in the sorted portion.
-//  - The algorithm maintains two subarrays: one that is sorted (on the left) and 
+template <typename Instrumentation>
+template <typename T, typename Before>
+void BasicSorting<Instrumentation>::mergeLow(T* base, size_t leftSize, size_t rightSize, RunMergeState<T>& state, Before& before) {
+    // Left run in the buffer, merged front to back into base.
+    std::move(base, base + leftSize, state.buffer.get());
+    T* left{state.buffer.get()};
+    T* leftEnd{left + leftSize};
+    T* right{base + leftSize};
+    T* rightEnd{right + rightSize};
+    T* out{base};
+    size_t straight{state.blockMerging ? powerSortVectorHandOff - 1 : 0};
+    while (left < leftEnd && right < rightEnd) {
+        size_t leftWins{}, rightWins{};
+        while (left < leftEnd && right < rightEnd && std::max(leftWins, rightWins) < state.minGallop) {
+            if (before(*right, *left)) {
+                *out++ = std::move(*right++);
+                ++rightWins;
+                leftWins = 0;
+            }
+            else {
+                *out++ = std::move(*left++);
+                ++leftWins;
+                rightWins = 0;
+            }
+            if constexpr (vectorized<T, true>) {
+                // The runs interleave finely here, so the vector kernel merges the next 
+                // powerSortVectorBlock left elements with the right elements that go 
+                // before the last of them, its output trailing the unread right run. 
+                // While blocks interleave evenly the next one follows at once; otherwise 
+                // straight merging and galloping resume.
+                if (state.vectorWidth > 0 && ++straight >= powerSortVectorHandOff && left < leftEnd && right < rightEnd) {
+                    size_t fromLeft{std::min(static_cast<size_t>(leftEnd - left), powerSortVectorBlock)};
+                    size_t fromRight{gallop<false>(left[fromLeft - 1], right, static_cast<size_t>(rightEnd - right), 0, before)};
+                    state.blockMerging = false;
+                    if (std::min(fromLeft, fromRight) >= state.vectorWidth) {
+                        sortingDetail::simd::merge(left, fromLeft, right, fromRight, out);
+                        left += fromLeft;
+                        right += fromRight;
+                        out += fromLeft + fromRight;
+                        state.blockMerging = std::max(fromLeft, fromRight) <= 4 * std::min(fromLeft, fromRight);
+                    }
+                    straight = state.blockMerging ? powerSortVectorHandOff - 1 : 0;
+                }
+            }
+        }
+        if (left < leftEnd && right < rightEnd) {
+            // One side kept winning: gallop, and leave block merging.
+            straight = 0;
+            state.blockMerging = false;
+        }
+        while (left < leftEnd && right < rightEnd) {
+            size_t fromLeft{gallop<true>(*right, left, static_cast<size_t>(leftEnd - left), 0, before)};
+            out = std::move(left, left + fromLeft, out);
+            left += fromLeft;
+            if (left == leftEnd) {
+                break;
+            }
+            size_t fromRight{gallop<false>(*left, right, static_cast<size_t>(rightEnd - right), 0, before)};
+            out = std::move(right, right + fromRight, out);
+            right += fromRight;
+            if (fromLeft < initialMinGallop && fromRight < initialMinGallop) {
+                ++state.minGallop;
+                break;
+            }
+            state.minGallop -= state.minGallop > 1;
+        }
+    }
+    std::move(left, leftEnd, out);
+}
+
+template <typename Instrumentation>
+template <typename T, typename Before>
+void BasicSorting<Instrumentation>::mergeHigh(T* base, size_t leftSize, size_t rightSize, RunMergeState<T>& state, Before& before) {
+    // Right run in the buffer, merged back to front into base.
+    std::move(base + leftSize, base + leftSize + rightSize, state.buffer.get());
+    T* right{state.buffer.get()};
+    T* rightEnd{right + rightSize};
+    T* leftEnd{base + leftSize};
+    T* out{base + leftSize + rightSize};
+    size_t straight{state.blockMerging ? powerSortVectorHandOff - 1 : 0};
+    while (base < leftEnd && right < rightEnd) {
+        size_t leftWins{}, rightWins{};
+        while (base < leftEnd && right < rightEnd && std::max(leftWins, rightWins) < state.minGallop) {
+            if (before(*(rightEnd - 1), *(leftEnd - 1))) {
+                *--out = std::move(*--leftEnd);
+                ++leftWins;
+                rightWins = 0;
+            }
+            else {
+                *--out = std::move(*--rightEnd);
+                ++rightWins;
+                leftWins = 0;
+            }
+            if constexpr (vectorized<T, true>) {
+                // As in mergeLow, with the block taken from the end of the right run. The 
+                // kernel merges front to back, so the left elements of the block first 
+                // move up against out and the output trails them.
+                if (state.vectorWidth > 0 && ++straight >= powerSortVectorHandOff && base < leftEnd && right < rightEnd) {
+                    size_t fromRight{std::min(static_cast<size_t>(rightEnd - right), powerSortVectorBlock)};
+                    size_t leftRemaining{static_cast<size_t>(leftEnd - base)};
+                    size_t fromLeft{leftRemaining - gallop<true>(*(rightEnd - fromRight), base, leftRemaining, leftRemaining - 1, before)};
+                    state.blockMerging = false;
+                    if (std::min(fromLeft, fromRight) >= state.vectorWidth) {
+                        T* target{out - fromLeft - fromRight};
+                        std::copy_backward(leftEnd - fromLeft, leftEnd, out);
+                        sortingDetail::simd::merge(out - fromLeft, fromLeft, rightEnd - fromRight, fromRight, target);
+                        out = target;
+                        leftEnd -= fromLeft;
+                        rightEnd -= fromRight;
+                        state.blockMerging = std::max(fromLeft, fromRight) <= 4 * std::min(fromLeft, fromRight);
+                    }
+                    straight = state.blockMerging ? powerSortVectorHandOff - 1 : 0;
+                }
+            }
+        }
+        if (base < leftEnd && right < rightEnd) {
+            // One side kept winning: gallop, and leave block merging.
+            straight = 0;
+            state.blockMerging = false;
+        }
+        while (base < leftEnd && right < rightEnd) {
+            size_t leftRemaining{static_cast<size_t>(leftEnd - base)};
+            size_t keepLeft{gallop<true>(*(rightEnd - 1), base, leftRemaining, leftRemaining - 1, before)};
+            out = std::move_backward(base + keepLeft, leftEnd, out);
+            size_t fromLeft{leftRemaining - keepLeft};
+            leftEnd = base + keepLeft;
+            if (leftEnd == base) {
+                break;
+            }
+            size_t rightRemaining{static_cast<size_t>(rightEnd - right)};
+            size_t keepRight{gallop<false>(*(leftEnd - 1), right, rightRemaining, rightRemaining - 1, before)};
+            out = std::move_backward(right + keepRight, rightEnd, out);
+            size_t fromRight{rightRemaining - keepRight};
+            rightEnd = right + keepRight;
+            if (fromLeft < initialMinGallop && fromRight < initialMinGallop) {
+                ++state.minGallop;
+                break;
+            }
+            state.minGallop -= state.minGallop > 1;
+        }
+    }
+    std::move_backward(right, rightEnd, out);
+}
+
+template <typename Instrumentation>
+template <typename T, typename Before>
+void BasicSorting<Instrumentation>::mergeRuns(T* base, size_t leftSize, size_t rightSize, RunMergeState<T>& state, Before& before) {
+    // Merges the adjacent sorted runs base[0, leftSize) and base[leftSize, leftSize + rightSize).
+    [[maybe_unused]] auto phase{instrumentation.phase(SortPhase::merge)};
+    size_t inPlace{gallop<true>(base[leftSize], base, leftSize, 0, before)};
+    base += inPlace;
+    leftSize -= inPlace;
+    if (leftSize == 0) {
+        return;
+    }
+    rightSize = gallop<false>(base[leftSize - 1], base + leftSize, rightSize, rightSize - 1, before);
+    if (rightSize == 0) {
+        return;
+    }
+
+    size_t shorter{std::min(leftSize, rightSize)};
+    if (state.capacity < shorter) {
+        state.capacity = shorter;
+        state.buffer.reset();
+        state.buffer = std::make_unique_for_overwrite<T[]>(state.capacity);
+        instrumentation.countAllocation(state.capacity * sizeof(T));
+    }
+    instrumentation.countMoves(leftSize + rightSize + shorter);
+    if (leftSize <= rightSize) {
+        mergeLow(base, leftSize, rightSize, state, before);
+    }
+    else {
+        mergeHigh(base, leftSize, rightSize, state, before);
+    }
+}
+
+template <typename Instrumentation>
+template <typename T, typename Compare, typename Projection>
+void BasicSorting<Instrumentation>::powerSort(std::vector<T>& vec, Compare compare, Projection projection) {
+    InstrumentedCall call{instrumentation};
+    size_t size{vec.size()};
+    if (size < 2) {
+        return;
+    }
+    auto before = [&](const T& a, const T& b) {
+        instrumentation.countComparison();
+        return static_cast<bool>(std::invoke(compare, std::invoke(projection, a), std::invoke(projection, b)));
+    };
+    RunMergeState<T> state;
+    if constexpr (vectorized<T, true>) {
+        if (std::is_same_v<Projection, std::identity>
+            && (std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<T>>)) {
+            state.vectorWidth = sortingDetail::simd::registerWidth<T>();
+        }
+    }
+    T* data{vec.data()};
+    size_t minRun{state.vectorWidth > 0 ? sortingDetail::simd::networkMaxSize : powerSortMinRun};
+    auto runEnd = [&](size_t begin) {
+        size_t length{countRun(data + begin, data + size, before)};
+        if (length < minRun && begin + length < size) {
+            size_t extended{std::min(minRun, size - begin)};
+            bool network{false};
+            if constexpr (vectorized<T, true>) {
+                // The network sorts the elements after the run found, which are then 
+                // merged into it; a run shorter than a register is cheaper to sort 
+                // again with the rest. Equal integers are indistinguishable, so the 
+                // unstable network will do.
+                if (state.vectorWidth > 0 && length < state.vectorWidth) {
+                    network = sortingDetail::simd::sortNetwork(data + begin, extended);
+                }
+                else if (state.vectorWidth > 0) {
+                    network = sortingDetail::simd::sortNetwork(data + begin + length, extended - length);
+                    if (network) {
+                        mergeRuns(data + begin, length, extended - length, state, before);
+                    }
+                }
+            }
+            if (!network) {
+                binaryInsertionSort(data + begin, data + begin + length, data + begin + extended, before);
+            }
+            length = extended;
+        }
+        return begin + length;
+    };
+    // Power of the boundary between [begin, mid) and [mid, end): the first bit at which 
+    // the binary fractions of the two run midpoints, relative to size, differ.
+    auto boundaryPower = [size](size_t begin, size_t mid, size_t end) {
+        size_t a{begin + mid};
+        size_t b{mid + end};
+        size_t power{};
+        while (true) {
+            ++power;
+            if (a >= size) {
+                a -= size;
+                b -= size;
+            }
+            else if (b >= size) {
+                return power;
+            }
+            a *= 2;
+            b *= 2;
+        }
+    };
+
+    struct PendingRun {
+        size_t begin;
+        size_t power;
+    };
+    std::array<PendingRun, 64> pending;
+    size_t pendingCount{};
+    size_t begin{};
+    size_t end{runEnd(0)};
+    while (end < size) {
+        size_t nextEnd{runEnd(end)};
+        size_t power{boundaryPower(begin, end, nextEnd)};
+        while (pendingCount > 0 && pending[pendingCount - 1].power > power) {
+            size_t previous{pending[--pendingCount].begin};
+            mergeRuns(data + previous, begin - previous, end - begin, state, before);
+            begin = previous;
+        }
+        pending[pendingCount++] = {begin, power};
+        begin = end;
+        end = nextEnd;
+    }
+    while (pendingCount > 0) {
+        size_t previous{pending[--pendingCount].begin};
+        mergeRuns(data + previous, begin - previous, end - begin, state, before);
+        begin = previous;
+    }
+}
+
+// ***********************************************************************
+//                            Quick Sort Algorithm
+// ***********************************************************************
+//
+// ** Time Complexity: **
+//  - Worst Case: O(n log n) (Introsort: after log2(n) badly unbalanced 
+//                            partitions the remaining range is heap sorted)
+//  - Best Case: O(n)        (Occurs when all keys are equal, since the fat 
+//                            partition removes the whole equal run in one pass)
+//  - Average Case: O(n log n) (Median-of-3 / ninther pivots keep partitions 
+//                            balanced on sorted, reversed and random input)
+//
+// ** Space Complexity: **
+//  - O(log n)               (Fixed-size explicit stack of deferred ranges; the 
+//                            smaller side is always processed first)
+//
+// ** Stability: **
+//  - Unstable               (May change the relative order of equal elements)
+//
+// ** Characteristics: **
+//  - Comparison-based sorting algorithm
+//  - A divide-and-conquer sorting algorithm that works by selecting a "pivot" element 
+//    from the array and partitioning the other elements into two sub-arrays according 
+//    to whether they are less than or greater than the pivot.
+//  - Duplicate keys are handled with a fat partition: when the pivot equals the key 
+//    just before the range, every key equal to it is gathered in one pass and never 
+//    touched again, so inputs with k distinct keys take O(n log k).
+//  - The pivot is the median of three elements, or the median of three medians 
+//    (Tukey's ninther) for ranges larger than nintherThreshold.
+//  - Ranges of at most insertionSortThreshold elements are finished with Insertion Sort.
+//  - For std::int32_t, std::int64_t, float and double on CPUs with AVX2 or AVX-512 
+//    (see sortingAlgorithmsSimd.tpp), both partitions compare a whole register against 
+//    the pivot at once and store its two sides without branches, and ranges of up to 
+//    64 elements are finished by a bitonic sorting network instead.
+//  - A partition whose smaller side holds less than 1/8 of the range counts as bad. 
+//    After a bad partition a few fixed elements of each side are swapped with ones a 
+//    quarter of the way in (pattern breaking, as in pdqsort), so inputs such as 
+//    organ pipes stop producing bad pivots. Only after log2(n) bad partitions does 
+//    the range fall back to Heap Sort, which bounds the worst case at O(n log n) 
+//    even on adversarial input.
+//  - There is no recursion: the larger side is pushed on a small fixed-size stack and 
+//    the loop continues with the smaller side, so the stack holds at most log2(n) ranges.
+//  - With more than one thread (see setThreadCount()) a larger side of at least 
+//    parallelGrain elements is handed to the work-stealing pool instead of the stack.
+//  - Indices are size_t, so vectors with more than 2^31 elements are supported.
+//  - The algorithm is not stable, meaning equal elements might not maintain their 
+//    relative order after sorting.
+//
+// ** Invariant: **
+//  - After partitioning, the pivot (or the whole run of keys equal to it) is "locked" 
+//    in its final position, with smaller elements to the left and greater ones to the right.
+//  - Every range on the deferred stack is disjoint from the range being processed and 
+//    its elements lie between the already placed keys on either side of it.
+//  - Once the stack is empty and the current range is finished, the sorting is complete.
+//
+// ***********************************************************************
+
+template <typename Instrumentation>
+template <typename T>
+void BasicSorting<Instrumentation>::sortThree(std::vector<T>& vec, size_t a, size_t b, size_t c) {
+    if (less(vec[b], vec[a])) {
+        swapElements(vec[a], vec[b]);
+    }
+    if (less(vec[c], vec[b])) {
+        swapElements(vec[b], vec[c]);
+        if (less(vec[b], vec[a])) {
+            swapElements(vec[a], vec[b]);
+        }
+    }
+}
+
+template <typename Instrumentation>
+template <typename T>
+void BasicSorting<Instrumentation>::choosePivot(std::vector<T>& vec, size_t first, size_t last) {
+    size_t size{last - first};
+    size_t mid{first + size / 2};
+    if (size > nintherThreshold) {
+        sortThree(vec, first, mid, last - 1);
+        sortThree(vec, first + 1, mid - 1, last - 2);
+        sortThree(vec, first + 2, mid + 1, last - 3);
+        sortThree(vec, mid - 1, mid, mid + 1);
+    }
+    else {
+        sortThree(vec, first, mid, last - 1);
+    }
+    swapElements(vec[first], vec[mid]);
+}
+
+template <typename Instrumentation>
+template <typename T>
+void BasicSorting<Instrumentation>::breakPatterns(std::vector<T>& vec, size_t first, size_t last) {
+    // Swaps the elements at both ends of one side of a bad partition with elements a 
+    // quarter of the way in, which moves the next median-of-3 samples off the pattern.
+    size_t size{last - first};
+    if (size < insertionSortThreshold) {
+        return;
+    }
+    size_t quarter{size / 4};
+    swapElements(vec[first], vec[first + quarter]);
+    swapElements(vec[last - 1], vec[last - 1 - quarter]);
+    if (size > nintherThreshold) {
+        swapElements(vec[first + 1], vec[first + quarter + 1]);
+        swapElements(vec[first + 2], vec[first + quarter + 2]);
+        swapElements(vec[last - 2], vec[last - 2 - quarter]);
+        swapElements(vec[last - 3], vec[last - 3 - quarter]);
+    }
+}
+
+template <typename Instrumentation>
+template <typename T>
+size_t BasicSorting<Instrumentation>::partition(std::vector<T>& vec, size_t first, size_t last) {
+    // Hoare-style partition around the pivot at vec[first]: keys less than the 
+    // pivot end up on its left, all others on its right. choosePivot() leaves a 
+    // key >= pivot behind it, so the left scan needs no bounds check.
+    if constexpr (vectorized<T>) {
+        size_t lessCount{};
+        if (sortingDetail::simd::partition<false>(vec.data() + first + 1, last - first - 1, vec[first], lessCount)) {
+            std::swap(vec[first], vec[first + lessCount]);
+            return first + lessCount;
+        }
+    }
+    [[maybe_unused]] auto phase{instrumentation.phase(SortPhase::partition)};
+    T pivot{std::move(vec[first])};
+    size_t i{first}, j{last};
+    while (less(vec[++i], pivot)) {}
+    if (i - 1 == first) {
+        while (i < j && !less(vec[--j], pivot)) {}
+    }
+    else {
+        while (!less(vec[--j], pivot)) {}
+    }
+    while (i < j) {
+        swapElements(vec[i], vec[j]);
+        while (less(vec[++i], pivot)) {}
+        while (!less(vec[--j], pivot)) {}
+    }
+    size_t pivotIndex{i - 1};
+    vec[first] = std::move(vec[pivotIndex]);
+    vec[pivotIndex] = std::move(pivot);
+    instrumentation.countMoves(3);
+    return pivotIndex;
+}
+
+template <typename Instrumentation>
+template <typename T>
+size_t BasicSorting<Instrumentation>::partitionEqual(std::vector<T>& vec, size_t first, size_t last) {
+    // Fat partition used when the pivot equals the key just before the range: 
+    // no key in the range can be smaller, so every key equal to the pivot is 
+    // gathered on the left and is already in its final position. Returns the 
+    // end of that equal run.
+    if constexpr (vectorized<T>) {
+        size_t equalCount{};
+        if (sortingDetail::simd::partition<true>(vec.data() + first + 1, last - first - 1, vec[first], equalCount)) {
+            return first + 1 + equalCount;
+        }
+    }
+    [[maybe_unused]] auto phase{instrumentation.phase(SortPhase::partition)};
+    T pivot{std::move(vec[first])};
+    size_t i{first}, j{last};
+    while (less(pivot, vec[--j])) {}
+    if (j + 1 == last) {
+        while (i < j && !less(pivot, vec[++i])) {}
+    }
+    else {
+        while (!less(pivot, vec[++i])) {}
+    }
+    while (i < j) {
+        swapElements(vec[i], vec[j]);
+        while (less(pivot, vec[--j])) {}
+        while (!less(pivot, vec[++i])) {}
+    }
+    vec[first] = std::move(vec[j]);
+    vec[j] = std::move(pivot);
+    instrumentation.countMoves(3);
+    return j + 1;
+}
+
+template <typename Instrumentation>
+template <typename T>
+void BasicSorting<Instrumentation>::introSortLoop(TaskPool* pool, TaskGroup* group, std::vector<T>& vec, size_t left, 
+                                                  size_t first, size_t last, size_t badBudget, size_t depth) {
+    struct Range {
+        size_t first;
+        size_t last;
+        size_t badBudget;
+        size_t depth;
+    };
+    std::array<Range, 64> pending;
+    size_t pendingCount{};
+    size_t smallRangeLimit{insertionSortThreshold};
+    if constexpr (vectorized<T>) {
+        if (simdLevel() != SimdLevel::scalar) {
+            smallRangeLimit = sortingDetail::simd::networkMaxSize;
+        }
+    }
+
+    while (true) {
+        instrumentation.recordDepth(depth);
+        size_t size{last - first};
+        if (size <= smallRangeLimit) {
+            sortSmallRange<false>(vec.data() + first, vec.data() + last);
+        }
+        else if (badBudget == 0) {
+            heapSortRange(vec, first, last);
+        }
+        else {
+            ++depth;
+            choosePivot(vec, first, last);
+            // vec[first - 1] is a placed key no greater than anything in the range; 
+            // if the pivot equals it, strip the whole equal run in one pass.
+            if (first > left && !less(vec[first - 1], vec[first])) {
+                first = partitionEqual(vec, first, last);
+                continue;
+            }
+            size_t pivotIndex{partition(vec, first, last)};
+            if (std::min(pivotIndex - first, last - pivotIndex - 1) < size / 8) {
+                --badBudget;
+                breakPatterns(vec, first, pivotIndex);
+                breakPatterns(vec, pivotIndex + 1, last);
+            }
+            Range larger{};
+            if (pivotIndex - first < last - pivotIndex - 1) {
+                larger = {pivotIndex + 1, last, badBudget, depth};
+                last = pivotIndex;
+            }
+            else {
+                larger = {first, pivotIndex, badBudget, depth};
+                first = pivotIndex + 1;
+            }
+            if (pool != nullptr && larger.last - larger.first >= parallelGrain) {
+                pool->run(*group, [=, this, &vec] {
+                    introSortLoop(pool, group, vec, left, larger.first, larger.last, larger.badBudget, larger.depth);
+                });
+            }
+            else {
+                pending[pendingCount++] = larger;
+            }
+            continue;
+        }
+
+        if (pendingCount == 0) {
+            return;
+        }
+        --pendingCount;
+        first = pending[pendingCount].first;
+        last = pending[pendingCount].last;
+        badBudget = pending[pendingCount].badBudget;
+        depth = pending[pendingCount].depth;
+    }
+}
+
+template <typename Instrumentation>
+template <typename T>
+void BasicSorting<Instrumentation>::quickSort(std::vector<T>& vec, size_t left, size_t right) {
+    InstrumentedCall call{instrumentation};
+    if (vec.empty() || left >= right) {
+        return;
+    }
+    size_t size{right - left + 1};
+    size_t badBudget{static_cast<size_t>(std::bit_width(size))};
+    unsigned threads{resolvedThreadCount()};
+    if (threads > 1 && size >= 2 * parallelGrain) {
+        TaskGroup group;
+        TaskPool pool{threads};
+        GroupJoin join{pool, group};
+        introSortLoop(&pool, &group, vec, left, left, right + 1, badBudget, 0);
+        pool.wait(group);
+    }
+    else {
+        introSortLoop<T>(nullptr, nullptr, vec, left, left, right + 1, badBudget, 0);
+    }
+}
+
+// ***********************************************************************
+//                            Selection and Top-K
+// ***********************************************************************
+//
+// ** Time Complexity: **
+//  - nthElement: O(n)             (Worst case too: see the median-of-medians fallback)
+//  - partialSort: O(n log k)      (Worst case, for input in descending order; on 
+//                                  random input most elements are rejected by one 
+//                                  comparison with the heap root, O(n + k log k log(n/k)))
+//  - topK / TopKStream: as partialSort, plus O(k log k) for sorted()
+//
+// ** Space Complexity: **
+//  - nthElement, partialSort: O(1) (In place; the median-of-medians recursion is 
+//                                  O(log n) deep)
+//  - topK / TopKStream: O(k)      (Only the heap of the k smallest values is stored, 
+//                                  however long the input)
+//
+// ** Stability: **
+//  - Unstable
+//
+// ** Characteristics: **
+//  - nthElement is introselect: Quick Sort's pivot choice and partitions, but only the 
+//    side containing nth is kept, so the work shrinks geometrically. Ranges of at most 
+//    insertionSortThreshold elements are finished by sorting them.
+//  - If the range has not halved after two partitions, the pivots switch to the median 
+//    of medians (the median of the medians of groups of 5), which is guaranteed to 
+//    discard at least 3/10 of the range, so adversarial input cannot force O(n^2).
+//  - partialSort, topK and TopKStream keep a max-heap of the k smallest values seen so 
+//    far: a value below the root replaces it and is sifted down, anything else is 
+//    rejected with one comparison. The heap is the same heapArity-ary bottom-up heap 
+//    that Heap Sort uses.
+//
+// ** Invariant: **
+//  - nthElement: every element before the current range is no greater, and every 
+//    element after it no smaller, than any element inside it, and nth is inside it.
+//  - Top-k: the heap holds the k smallest values seen so far and its root is the 
+//    largest of them.
+//
+// ***********************************************************************
+
+template <typename Instrumentation>
+template <typename T>
+void BasicSorting<Instrumentation>::medianOfMediansPivot(std::vector<T>& vec, size_t first, size_t last) {
+    // Moves the median of each group of 5 to the front of the range, selects the 
+    // median of those, and leaves it at vec[first] as the pivot.
+    size_t groups{(last - first) / 5};
+    for (size_t group{}; group < groups; ++group) {
+        size_t start{first + 5 * group};
+        insertionSortRange(vec.begin() + start, vec.begin() + start + 5);
+        swapElements(vec[first + group], vec[start + 2]);
+    }
+    selectRange(vec, first, first, first + groups, first + groups / 2);
+    swapElements(vec[first], vec[first + groups / 2]);
+}
+
+template <typename Instrumentation>
+template <typename T>
+void BasicSorting<Instrumentation>::selectRange(std::vector<T>& vec, size_t left, size_t first, size_t last, size_t nth) {
+    size_t checkpointSize{last - first};
+    size_t partitions{};
+    bool medianOfMedians{false};
+    while (last - first > insertionSortThreshold) {
+        if (medianOfMedians) {
+            medianOfMediansPivot(vec, first, last);
+        }
+        else {
+            choosePivot(vec, first, last);
+        }
+        if (first > left && !less(vec[first - 1], vec[first])) {
+            first = partitionEqual(vec, first, last);
+            if (nth < first) {
+                return;
+            }
+        }
+        else {
+            size_t pivotIndex{partition(vec, first, last)};
+            if (nth == pivotIndex) {
+                return;
+            }
+            if (nth < pivotIndex) {
+                last = pivotIndex;
+            }
+            else {
+                first = pivotIndex + 1;
+            }
+        }
+        if (++partitions % 2 == 0) {
+            medianOfMedians = medianOfMedians || last - first > checkpointSize / 2;
+            checkpointSize = last - first;
+        }
+    }
+    sortSmallRange<false>(vec.data() + first, vec.data() + last);
+}
+
+template <typename Instrumentation>
+template <typename T>
+void BasicSorting<Instrumentation>::nthElement(std::vector<T>& vec, size_t nth) {
+    InstrumentedCall call{instrumentation};
+    if (nth >= vec.size()) {
+        return;
+    }
+    selectRange(vec, 0, 0, vec.size(), nth);
+}
+
+template <typename Instrumentation>
+template <typename T>
+void BasicSorting<Instrumentation>::partialSort(std::vector<T>& vec, size_t k) {
+    InstrumentedCall call{instrumentation};
+    k = std::min(k, vec.size());
+    if (k == 0) {
+        return;
+    }
+    makeHeap(vec, 0, k);
+    {
+        [[maybe_unused]] auto phase{instrumentation.phase(SortPhase::heapify)};
+        for (size_t i{k}; i < vec.size(); ++i) {
+            if (less(vec[i], vec[0])) {
+                swapElements(vec[0], vec[i]);
+                heapify(vec, 0, k, 0);
+            }
+        }
+    }
+    sortHeap(vec, 0, k);
+}
+
+template <typename Instrumentation>
+template <typename T>
+std::vector<T> BasicSorting<Instrumentation>::topK(const std::vector<T>& vec, size_t k) {
+    InstrumentedCall call{instrumentation};
+    TopKStream<T> stream{*this, std::min(k, vec.size())};
+    for (const T& value : vec) {
+        stream.push(value);
+    }
+    return stream.sorted();
+}
+
+template <typename Instrumentation>
+template <typename T>
+template <typename U>
+void BasicSorting<Instrumentation>::TopKStream<T>::insert(U&& value) {
+    // The heap is only built once it is full; until then values are just collected. 
+    // Afterwards a value is compared against the root before it is copied.
+    if (heap.size() < k) {
+        heap.push_back(std::forward<U>(value));
+        if (heap.size() == k) {
+            sorting.makeHeap(heap, 0, k);
+        }
+    }
+    else if (k > 0 && sorting.less(value, heap[0])) {
+        heap[0] = std::forward<U>(value);
+        sorting.heapify(heap, 0, k, 0);
+    }
+}
+
+template <typename Instrumentation>
+template <typename T>
+std::vector<T> BasicSorting<Instrumentation>::TopKStream<T>::sorted() const {
+    std::vector<T> result{heap};
+    sorting.heapSortRange(result, 0, result.size());
+    return result;
+}
+
+// ***********************************************************************
+//                            Selection Sort Algorithm
+// ***********************************************************************
+//
+// ** Time Complexity: **
+//  - Worst Case: O(n^2)     (Occurs regardless of the input, as Selection Sort 
+//                            always performs a nested loop to find the minimum element)
+//  - Best Case: O(n^2)      (Even if the array is already sorted, Selection Sort 
+//                            still goes through the entire array)
+//  - Average Case: O(n^2)   (Same as worst case, since it always performs n^2 operations)
+//
+// ** Space Complexity: **
+//  - O(1)                   (In-place sorting, no extra space required for sorting)
+//
+// ** Stability: **
+//  - Unstable               (May change the relative order of equal elements)
+//
+// ** Characteristics: **
+//  - Comparison-based sorting algorithm
+//  - Iteratively selects the smallest element from the unsorted portion of the array
+//    and places it in its correct position in the sorted portion.
+//  - The algorithm maintains two subarrays: one that is sorted (on the left) and 
 //    another that is unsorted (on the right).
 //  - The time complexity of Selection Sort is always O(n^2) because for each 
 //    element, it searches the entire remaining unsorted array for the minimum element.
@@ -469,20 +1977,469 @@ void Sorting::quickSort(std::vector<T>& vec, int left, int right) {
 //
 // ***********************************************************************
 
+template <typename Instrumentation>
 template <typename T>
-void Sorting::selectionSort(std::vector<T>& vec) {
+void BasicSorting<Instrumentation>::selectionSort(std::vector<T>& vec) {
+    InstrumentedCall call{instrumentation};
     size_t smallestIndex{};
     size_t size{vec.size()};
     for (size_t i{}; i < size - 1; ++i) {
         smallestIndex = i;
         for (size_t j{i + 1}; j < size; ++j) {
-            if (vec[j] < vec[smallestIndex]) {
+            if (less(vec[j], vec[smallestIndex])) {
                 smallestIndex = j;
             }
         }
         if (smallestIndex != i) {
-            std::swap(vec[i], vec[smallestIndex]);
+            swapElements(vec[i], vec[smallestIndex]);
+        }
+    }
+}
+
+// ***********************************************************************
+//                            External Merge Sort
+// ***********************************************************************
+//
+// ** Time Complexity: **
+//  - O(n log n) comparisons, plus O(n * (1 + passes)) bytes of sequential I/O, where 
+//    passes = ceil(log_fanIn(runs)) and is 1 whenever the runs fit one merge
+//
+// ** Space Complexity: **
+//  - O(min(memoryBudget, input size))  (Every buffer is sized from the smaller of 
+//                                        ExternalSortOptions::memoryBudget and the input)
+//  - O(n) temporary disk    (Sorted runs are spilled to ExternalSortOptions::tempDirectory)
+//
+// ** Stability: **
+//  - Stable                 (Runs are sorted with Merge Sort and ties between runs go to 
+//                            the run that came first in the input)
+//
+// ** Characteristics: **
+//  - Sorts a file of fixed-width records (ExternalSortOptions::recordSize bytes each) 
+//    that does not fit in memory. Records are ordered by key(const char* record), 
+//    whose result must support operator<.
+//  - Run formation: the input is read in large sequential chunks that fit the memory 
+//    budget. The (key, offset) pairs of a chunk are sorted with mergeSort (parallel if 
+//    threadCount > 1), and the records are written out in that order as one run. 
+//    While a chunk is sorted and written, the next one is read asynchronously into a 
+//    second buffer.
+//  - Merging: a loser tree picks the next record among the runs with one comparison per 
+//    tree level. Every run is read through two blocks, so the next block is fetched 
+//    asynchronously while the current one is consumed, and the output is written the 
+//    same way. If there are more runs than the budget (or the limit on open files, 
+//    RLIMIT_NOFILE) allows to merge at once, groups of runs are merged into longer 
+//    runs first.
+//  - I/O failures, a missing input file and an input size that is not a multiple of 
+//    the record size throw std::runtime_error. Temporary files are always removed.
+//
+// ** Invariant: **
+//  - Every run on disk is sorted, and concatenating the runs in creation order gives 
+//    back a permutation of the input.
+//  - The root of the loser tree is the run whose current record is the smallest; each 
+//    inner node stores the loser of the match played there.
+//
+// ***********************************************************************
+
+namespace sortingDetail {
+
+// Writes records through two blocks: one is filled while the other is written 
+// to disk asynchronously.
+class BlockWriter {
+public:
+    BlockWriter(const std::string& path, size_t blockBytes)
+        : file{path, std::ios::binary | std::ios::trunc} {
+        if (!file) {
+            throw std::runtime_error{"externalSort: cannot create " + path};
+        }
+        blocks[0].resize(blockBytes);
+        blocks[1].resize(blockBytes);
+    }
+
+    BlockWriter(const BlockWriter&) = delete;
+    BlockWriter& operator=(const BlockWriter&) = delete;
+
+    ~BlockWriter() {
+        if (pending.valid()) {
+            pending.wait();
+        }
+    }
+
+    void write(const char* record, size_t size) {
+        if (used + size > blocks[active].size()) {
+            flush();
+        }
+        std::copy(record, record + size, blocks[active].data() + used);
+        used += size;
+    }
+
+    void finish() {
+        flush();
+        if (pending.valid()) {
+            pending.get();
+        }
+        file.close();
+        if (!file) {
+            throw std::runtime_error{"externalSort: write failed"};
+        }
+    }
+
+private:
+    void flush() {
+        if (pending.valid()) {
+            pending.get();
+        }
+        if (used == 0) {
+            return;
+        }
+        const char* data{blocks[active].data()};
+        size_t size{used};
+        pending = std::async(std::launch::async, [this, data, size] {
+            if (!file.write(data, static_cast<std::streamsize>(size))) {
+                throw std::runtime_error{"externalSort: write failed"};
+            }
+        });
+        active ^= 1;
+        used = 0;
+    }
+
+    std::ofstream file;
+    std::array<std::vector<char>, 2> blocks;
+    size_t active{};
+    size_t used{};
+    std::future<void> pending;
+};
+
+// Reads fixed-width records through two blocks: the next block is fetched 
+// asynchronously while the current one is consumed.
+class BlockReader {
+public:
+    BlockReader(const std::string& path, size_t recordSize, size_t blockBytes)
+        : file{path, std::ios::binary}, path{path}, recordSize{recordSize} {
+        if (!file) {
+            throw std::runtime_error{"externalSort: cannot open " + path};
+        }
+        blocks[0].resize(blockBytes);
+        blocks[1].resize(blockBytes);
+        filled = readBlock(blocks[0]);
+        prefetch();
+    }
+
+    BlockReader(const BlockReader&) = delete;
+    BlockReader& operator=(const BlockReader&) = delete;
+
+    ~BlockReader() {
+        if (pending.valid()) {
+            pending.wait();
+        }
+    }
+
+    // The current record, or nullptr once the file is exhausted.
+    const char* current() const {
+        return position < filled ? blocks[active].data() + position : nullptr;
+    }
+
+    void advance() {
+        position += recordSize;
+        if (position < filled) {
+            return;
+        }
+        position = 0;
+        filled = pending.valid() ? pending.get() : 0;
+        active ^= 1;
+        prefetch();
+    }
+
+private:
+    size_t readBlock(std::vector<char>& block) {
+        file.read(block.data(), static_cast<std::streamsize>(block.size()));
+        if (file.bad()) {
+            throw std::runtime_error{"externalSort: cannot read " + path};
+        }
+        size_t bytes{static_cast<size_t>(file.gcount())};
+        if (bytes % recordSize != 0) {
+            throw std::runtime_error{"externalSort: file size is not a multiple of the record size"};
+        }
+        return bytes;
+    }
+
+    void prefetch() {
+        if (filled == blocks[active].size() && file) {
+            std::vector<char>& next{blocks[active ^ 1]};
+            pending = std::async(std::launch::async, [this, &next] { return readBlock(next); });
+        }
+    }
+
+    std::ifstream file;
+    std::string path;
+    size_t recordSize;
+    std::array<std::vector<char>, 2> blocks;
+    size_t active{};
+    size_t position{};
+    size_t filled{};
+    std::future<size_t> pending;
+};
+
+// Files the process may have open at once: the soft RLIMIT_NOFILE where the platform 
+// has one, unlimited otherwise.
+inline size_t openFileLimit() {
+#if defined(__unix__) || defined(__APPLE__)
+    rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY) {
+        return static_cast<size_t>(limit.rlim_cur);
+    }
+#endif
+    return std::numeric_limits<size_t>::max();
+}
+
+// Tournament tree of losers over k sources; less(a, b) orders the current heads 
+// of sources a and b.
+template <typename Less>
+class LoserTree {
+public:
+    LoserTree(size_t sourceCount, Less less) : k{sourceCount}, less{less}, nodes(std::max<size_t>(sourceCount, 1)) {
+        std::vector<size_t> winners(2 * k);
+        for (size_t i{}; i < k; ++i) {
+            winners[k + i] = i;
+        }
+        for (size_t node{k - 1}; node >= 1; --node) {
+            size_t a{winners[2 * node]};
+            size_t b{winners[2 * node + 1]};
+            bool aWins{this->less(a, b)};
+            winners[node] = aWins ? a : b;
+            nodes[node] = aWins ? b : a;
+        }
+        nodes[0] = k > 1 ? winners[1] : 0;
+    }
+
+    size_t winner() const {
+        return nodes[0];
+    }
+
+    // Replays the matches from the leaf of `source` up to the root after its head changed.
+    void replay(size_t source) {
+        size_t winner{source};
+        for (size_t node{(source + k) / 2}; node >= 1; node /= 2) {
+            if (less(nodes[node], winner)) {
+                std::swap(nodes[node], winner);
+            }
+        }
+        nodes[0] = winner;
+    }
+
+private:
+    size_t k;
+    Less less;
+    std::vector<size_t> nodes;
+};
+
+} // namespace sortingDetail
+
+template <typename Instrumentation>
+template <typename KeyExtractor>
+void BasicSorting<Instrumentation>::mergeExternalRuns(const std::vector<std::string>& runs, const std::string& outputPath, 
+                                                      size_t recordSize, size_t blockBytes, KeyExtractor& key) {
+    [[maybe_unused]] auto phase{instrumentation.phase(SortPhase::merge)};
+    instrumentation.countAllocation(2 * blockBytes * (runs.size() + 1));
+
+    // The key of each run's current record is extracted once, when the run advances, 
+    // rather than in every match of the loser tree.
+    using Key = std::decay_t<std::invoke_result_t<KeyExtractor&, const char*>>;
+    std::vector<std::unique_ptr<sortingDetail::BlockReader>> readers;
+    std::vector<Key> heads;
+    heads.reserve(runs.size());
+    for (const std::string& run : runs) {
+        readers.push_back(std::make_unique<sortingDetail::BlockReader>(run, recordSize, blockBytes));
+        const char* record{readers.back()->current()};
+        heads.push_back(record != nullptr ? key(record) : Key{});
+    }
+    auto headLess = [&](size_t a, size_t b) {
+        bool aDone{readers[a]->current() == nullptr};
+        bool bDone{readers[b]->current() == nullptr};
+        if (aDone || bDone) {
+            return bDone && !aDone;
+        }
+        // Ties go to the earlier run, which keeps the merge stable.
+        return a < b ? !less(heads[b], heads[a]) : less(heads[a], heads[b]);
+    };
+    sortingDetail::LoserTree<decltype(headLess)> tree{readers.size(), headLess};
+
+    sortingDetail::BlockWriter writer{outputPath, blockBytes};
+    size_t written{};
+    while (true) {
+        size_t source{tree.winner()};
+        const char* record{readers[source]->current()};
+        if (record == nullptr) {
+            break;
         }
+        writer.write(record, recordSize);
+        ++written;
+        readers[source]->advance();
+        if (const char* next{readers[source]->current()}) {
+            heads[source] = key(next);
+        }
+        tree.replay(source);
     }
+    writer.finish();
+    instrumentation.countMoves(written);
 }
 
+template <typename Instrumentation>
+template <typename KeyExtractor>
+void BasicSorting<Instrumentation>::externalSort(const std::string& inputPath, const std::string& outputPath, 
+                                                 const ExternalSortOptions& options, KeyExtractor key) {
+    InstrumentedCall call{instrumentation};
+    using Key = std::decay_t<std::invoke_result_t<KeyExtractor&, const char*>>;
+    struct Entry {
+        Key key;
+        size_t offset;
+
+        bool operator<(const Entry& other) const { return key < other.key; }
+    };
+
+    size_t recordSize{options.recordSize};
+    if (recordSize == 0) {
+        throw std::invalid_argument{"externalSort: recordSize must be positive"};
+    }
+    size_t budget{std::max(options.memoryBudget, 4 * (recordSize + sizeof(Entry)))};
+
+    // Removes every spilled run, including on failure.
+    struct TemporaryFiles {
+        std::vector<std::string> paths;
+
+        ~TemporaryFiles() {
+            for (const std::string& path : paths) {
+                std::error_code ignored;
+                std::filesystem::remove(path, ignored);
+            }
+        }
+    } temporaries;
+    std::filesystem::path tempDirectory{options.tempDirectory.empty() ? std::filesystem::temp_directory_path() 
+                                                                       : std::filesystem::path{options.tempDirectory}};
+    std::string tempPrefix{"sorting-run-" + std::to_string(std::random_device{}()) + "-"};
+    auto newTemporary = [&] {
+        temporaries.paths.push_back((tempDirectory / (tempPrefix + std::to_string(temporaries.paths.size()) + ".tmp")).string());
+        return temporaries.paths.back();
+    };
+    auto roundToRecords = [&](size_t bytes) {
+        return std::max(recordSize, bytes / recordSize * recordSize);
+    };
+
+    // Run formation: a chunk of records, its (key, offset) pairs and Merge Sort's 
+    // scratch copy of them, plus the double-buffered writer, fit in the budget. No 
+    // buffer is larger than the input, when its size is known. Input that takes more 
+    // than one chunk is read into two: the next chunk is read while the current one 
+    // is sorted and written.
+    std::error_code sizeError;
+    std::uintmax_t fileSize{std::filesystem::file_size(inputPath, sizeError)};
+    size_t inputBytes{sizeError ? budget : static_cast<size_t>(std::min<std::uintmax_t>(fileSize, budget))};
+    size_t writerBlock{roundToRecords(std::min({options.ioBlockSize, budget / 8, inputBytes}))};
+    size_t inputRecords{(inputBytes + recordSize - 1) / recordSize};
+    size_t chunkBudget{budget - 2 * writerBlock};
+    bool overlapped{inputRecords > chunkBudget / (recordSize + 2 * sizeof(Entry))};
+    size_t recordsPerRun{std::max<size_t>(1, std::min(inputRecords, 
+                                                      chunkBudget / ((overlapped ? 2 : 1) * recordSize + 2 * sizeof(Entry))))};
+    std::array<std::vector<char>, 2> chunks;
+    chunks[0].resize(recordsPerRun * recordSize);
+    if (overlapped) {
+        chunks[1].resize(recordsPerRun * recordSize);
+    }
+    std::vector<Entry> entries;
+    entries.reserve(recordsPerRun);
+    instrumentation.countAllocation(chunks[0].size() + chunks[1].size() + 2 * recordsPerRun * sizeof(Entry) 
+                                    + 2 * writerBlock);
+
+    std::ifstream input{inputPath, std::ios::binary};
+    if (!input) {
+        throw std::runtime_error{"externalSort: cannot open " + inputPath};
+    }
+    auto readChunk = [&input, &inputPath, recordSize](std::vector<char>& chunk) {
+        input.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        if (input.bad()) {
+            throw std::runtime_error{"externalSort: cannot read " + inputPath};
+        }
+        size_t bytes{static_cast<size_t>(input.gcount())};
+        if (bytes % recordSize != 0) {
+            throw std::runtime_error{"externalSort: file size is not a multiple of the record size"};
+        }
+        return bytes;
+    };
+    std::vector<std::string> runs;
+    bool singleRun{};
+    size_t active{};
+    size_t bytes{readChunk(chunks[active])};
+    while (bytes > 0) {
+        std::vector<char>& chunk{chunks[active]};
+        bool more{bytes == chunk.size() && input.peek() != std::ifstream::traits_type::eof()};
+        std::future<size_t> next;
+        if (more && overlapped) {
+            next = std::async(std::launch::async, readChunk, std::ref(chunks[active ^ 1]));
+        }
+
+        size_t count{bytes / recordSize};
+        entries.clear();
+        for (size_t i{}; i < count; ++i) {
+            entries.push_back({key(chunk.data() + i * recordSize), i * recordSize});
+        }
+        mergeSort(entries, 0, count - 1);
+
+        // A single chunk is the whole input: write it straight to the output.
+        singleRun = runs.empty() && !more;
+        std::string runPath{singleRun ? outputPath : newTemporary()};
+        sortingDetail::BlockWriter writer{runPath, writerBlock};
+        for (const Entry& entry : entries) {
+            writer.write(chunk.data() + entry.offset, recordSize);
+        }
+        writer.finish();
+        instrumentation.countMoves(count);
+        runs.push_back(runPath);
+
+        if (next.valid()) {
+            bytes = next.get();
+            active ^= 1;
+        }
+        else {
+            bytes = more ? readChunk(chunk) : 0;
+        }
+    }
+    input.close();
+    std::array<std::vector<char>, 2>{}.swap(chunks);
+    std::vector<Entry>{}.swap(entries);
+
+    if (singleRun) {
+        return;
+    }
+    if (runs.empty()) {
+        sortingDetail::BlockWriter{outputPath, recordSize}.finish();
+        return;
+    }
+
+    // Every merged run and the output get two blocks of at least minimumBlock bytes. 
+    // Each of them also holds a file open, and fileHeadroom descriptors below the 
+    // process limit are left to the caller.
+    constexpr size_t minimumBlock{size_t{64} << 10};
+    constexpr size_t fileHeadroom{32};
+    size_t blockPairs{budget / (2 * std::max(recordSize, minimumBlock))};
+    size_t fanIn{blockPairs > 3 ? blockPairs - 1 : 2};
+    size_t fileLimit{sortingDetail::openFileLimit()};
+    fanIn = std::clamp<size_t>(fileLimit > fileHeadroom + 1 ? fileLimit - fileHeadroom - 1 : 2, 2, fanIn);
+    while (runs.size() > fanIn) {
+        size_t blockBytes{roundToRecords(std::min(options.ioBlockSize, budget / (2 * (fanIn + 1))))};
+        std::vector<std::string> merged;
+        for (size_t group{}; group < runs.size(); group += fanIn) {
+            size_t groupEnd{std::min(runs.size(), group + fanIn)};
+            std::vector<std::string> groupRuns(runs.begin() + group, runs.begin() + groupEnd);
+            if (groupRuns.size() == 1) {
+                merged.push_back(groupRuns.front());
+                continue;
+            }
+            merged.push_back(newTemporary());
+            mergeExternalRuns(groupRuns, merged.back(), recordSize, blockBytes, key);
+            for (const std::string& run : groupRuns) {
+                std::error_code ignored;
+                std::filesystem::remove(run, ignored);
+            }
+        }
+        runs = std::move(merged);
+    }
+    size_t blockBytes{roundToRecords(std::min(options.ioBlockSize, budget / (2 * (runs.size() + 1))))};
+    mergeExternalRuns(runs, outputPath, recordSize, blockBytes, key);
+}
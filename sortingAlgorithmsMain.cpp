@@ -65,5 +65,250 @@ int main() {
     }
     std::cout << std::endl;
 
-    return 0;
+    // The tests below check their results against a reference and report any 
+    // failure through the exit code.
+    bool passed{true};
+    std::mt19937 generator{42};
+
+    std::cout << "Testing External Sort:" << std::endl;
+    {
+        // 16-byte records: a two-letter key, a space, the zero-padded input position 
+        // and a newline. Only four keys exist, so records with equal keys must come 
+        // out in input order.
+        constexpr size_t recordCount{10000};
+        std::vector<std::string> records;
+        for (size_t i{}; i < recordCount; ++i) {
+            std::string position{std::to_string(i)};
+            std::string key{static_cast<char>('a' + generator() % 2), static_cast<char>('a' + generator() % 2)};
+            records.push_back(key + " " + std::string(12 - position.size(), '0') + position + "\n");
+        }
+        std::filesystem::path directory{std::filesystem::temp_directory_path()};
+        std::string inputPath{(directory / "sorting-main-input.dat").string()};
+        std::string outputPath{(directory / "sorting-main-output.dat").string()};
+        {
+            std::ofstream input{inputPath, std::ios::binary};
+            for (const std::string& record : records) {
+                input << record;
+            }
+        }
+
+        // A 4 KiB budget holds a few dozen records, so the input is spilled to 
+        // hundreds of runs that take several merge passes.
+        ExternalSortOptions options;
+        options.recordSize = 16;
+        options.memoryBudget = 4096;
+        sorting.externalSort(inputPath, outputPath, options, [](const char* record) {
+            return std::string_view{record, 2};
+        });
+
+        std::stable_sort(records.begin(), records.end(), [](const std::string& a, const std::string& b) {
+            return a.compare(0, 2, b, 0, 2) < 0;
+        });
+        std::string expected;
+        for (const std::string& record : records) {
+            expected += record;
+        }
+        std::ifstream output{outputPath, std::ios::binary};
+        std::string actual{std::istreambuf_iterator<char>{output}, std::istreambuf_iterator<char>{}};
+        bool correct{actual == expected};
+        passed = passed && correct;
+        std::cout << recordCount << " records: " << (correct ? "stable and complete" : "FAILED") << std::endl;
+        std::filesystem::remove(inputPath);
+        std::filesystem::remove(outputPath);
+    }
+
+    std::cout << "Testing Selection and Top-K:" << std::endl;
+    {
+        // Random keys with many duplicates, plus sorted and constant inputs, which 
+        // are the usual worst cases for pivot selection.
+        std::vector<std::vector<int>> inputs(3, std::vector<int>(5000));
+        for (size_t i{}; i < inputs[0].size(); ++i) {
+            inputs[0][i] = static_cast<int>(generator() % 1000);
+            inputs[1][i] = static_cast<int>(i);
+            inputs[2][i] = 7;
+        }
+        bool correct{true};
+        for (const std::vector<int>& input : inputs) {
+            std::vector<int> reference{input};
+            std::sort(reference.begin(), reference.end());
+            for (size_t nth : {size_t{0}, size_t{1}, input.size() / 3, input.size() / 2, input.size() - 1}) {
+                std::vector<int> vec{input};
+                sorting.nthElement(vec, nth);
+                correct = correct && vec[nth] == reference[nth]
+                          && std::all_of(vec.begin(), vec.begin() + nth, [&](int x) { return x <= vec[nth]; })
+                          && std::all_of(vec.begin() + nth, vec.end(), [&](int x) { return x >= vec[nth]; });
+            }
+            for (size_t k : {size_t{0}, size_t{1}, size_t{10}, input.size() / 2, input.size()}) {
+                std::vector<int> prefix(reference.begin(), reference.begin() + k);
+                std::vector<int> vec{input};
+                sorting.partialSort(vec, k);
+                correct = correct && std::equal(prefix.begin(), prefix.end(), vec.begin());
+                std::sort(vec.begin(), vec.end());
+                correct = correct && vec == reference;
+
+                correct = correct && sorting.topK(input, k) == prefix;
+
+                auto stream = sorting.topKStream<int>(k);
+                for (int value : input) {
+                    stream.push(value);
+                }
+                correct = correct && stream.sorted() == prefix;
+            }
+        }
+        passed = passed && correct;
+        std::cout << "nthElement, partialSort, topK, topKStream: " << (correct ? "match a full sort" : "FAILED") << std::endl;
+    }
+
+    std::cout << "Testing Power Sort:" << std::endl;
+    {
+        // int keys take the vectorized run extension and merges where the CPU has 
+        // them; the shapes exercise descending runs, galloping and the block hand-off.
+        constexpr size_t size{100000};
+        std::vector<std::vector<int>> inputs(4, std::vector<int>(size));
+        for (size_t i{}; i < size; ++i) {
+            inputs[0][i] = static_cast<int>(generator() % 1000);
+            inputs[1][i] = static_cast<int>(generator());
+            inputs[2][i] = static_cast<int>(size - i);
+            inputs[3][i] = static_cast<int>(i % 4096);
+        }
+        for (size_t i{}; i < size / 100; ++i) {
+            std::swap(inputs[2][generator() % size], inputs[2][generator() % size]);
+        }
+        bool correct{true};
+        for (const std::vector<int>& input : inputs) {
+            for (size_t length : {size_t{0}, size_t{1}, size_t{63}, size_t{1000}, size}) {
+                std::vector<int> vec(input.begin(), input.begin() + length);
+                std::vector<int> reference{vec};
+                std::stable_sort(reference.begin(), reference.end());
+                sorting.powerSort(vec);
+                correct = correct && vec == reference;
+            }
+        }
+
+        // Records keep their input position, so equal keys must stay in input order, 
+        // also when sorting descending through a projection.
+        std::vector<std::pair<int, size_t>> records(size);
+        for (size_t i{}; i < size; ++i) {
+            records[i] = {static_cast<int>(generator() % 100), i};
+        }
+        std::sort(records.begin(), records.begin() + size / 2);
+        for (bool descending : {false, true}) {
+            std::vector<std::pair<int, size_t>> vec{records};
+            std::vector<std::pair<int, size_t>> reference{records};
+            if (descending) {
+                sorting.powerSort(vec, std::greater<>{}, &std::pair<int, size_t>::first);
+                std::stable_sort(reference.begin(), reference.end(), [](const auto& a, const auto& b) {
+                    return a.first > b.first;
+                });
+            }
+            else {
+                sorting.powerSort(vec, std::less<>{}, &std::pair<int, size_t>::first);
+                std::stable_sort(reference.begin(), reference.end(), [](const auto& a, const auto& b) {
+                    return a.first < b.first;
+                });
+            }
+            correct = correct && vec == reference;
+        }
+        passed = passed && correct;
+        std::cout << "int keys, records by projection: " << (correct ? "match std::stable_sort" : "FAILED") << std::endl;
+    }
+
+    std::cout << "Testing Counting Instrumentation:" << std::endl;
+    {
+        // Insertion Sort of n descending values compares every pair once and moves 
+        // each element i places plus two moves through the key; on ascending values 
+        // it makes n - 1 comparisons and no moves. The second call also shows that 
+        // the counters are reset between calls.
+        constexpr size_t size{100};
+        BasicSorting<CountingInstrumentation> counting;
+        std::vector<int> descending(size);
+        for (size_t i{}; i < size; ++i) {
+            descending[i] = static_cast<int>(size - i);
+        }
+        std::vector<int> reference{descending};
+        std::sort(reference.begin(), reference.end());
+
+        std::vector<int> vec{descending};
+        counting.insertionSort(vec);
+        SortStatistics statistics{counting.getInstrumentation().statistics()};
+        bool correct{vec == reference && statistics.comparisons == size * (size - 1) / 2
+                     && statistics.moves == size * (size - 1) / 2 + 2 * (size - 1)};
+        counting.insertionSort(vec);
+        statistics = counting.getInstrumentation().statistics();
+        correct = correct && statistics.comparisons == size - 1 && statistics.moves == 0;
+
+        // The other algorithms only have to sort and count something.
+        std::vector<int> input(5000);
+        for (int& value : input) {
+            value = static_cast<int>(generator() % 1000);
+        }
+        reference = input;
+        std::sort(reference.begin(), reference.end());
+        for (int algorithm{}; algorithm < 3; ++algorithm) {
+            vec = input;
+            if (algorithm == 0) {
+                counting.mergeSort(vec, 0, vec.size() - 1);
+            }
+            else if (algorithm == 1) {
+                counting.quickSort(vec, 0, vec.size() - 1);
+            }
+            else {
+                counting.powerSort(vec);
+            }
+            statistics = counting.getInstrumentation().statistics();
+            correct = correct && vec == reference && statistics.comparisons > 0 && statistics.moves > 0;
+        }
+        passed = passed && correct;
+        std::cout << "insertionSort counts, mergeSort, quickSort, powerSort: " 
+                  << (correct ? "sorted and counted" : "FAILED") << std::endl;
+    }
+
+    std::cout << "Testing Bucket Sort on skewed keys:" << std::endl;
+    {
+        // Records keep their input position, so a bucket that loses the input order 
+        // of equal keys shows up. Most keys fall on a handful of values, which leaves 
+        // a few buckets with most of the input, and one input has a single key. 
+        // Sorting(0) uses every core and Sorting(4) four threads even on a single 
+        // core, so the parallel path (from 2 * parallelGrain elements) always runs.
+        struct Record {
+            int key;
+            size_t position;
+
+            bool operator<(const Record& other) const { return key < other.key; }
+            bool operator==(const Record&) const = default;
+        };
+        constexpr size_t size{100000};
+        std::vector<std::vector<Record>> records(2, std::vector<Record>(size));
+        std::vector<double> doubles(size);
+        for (size_t i{}; i < size; ++i) {
+            int key{generator() % 4 == 0 ? static_cast<int>(generator() % 100000) : static_cast<int>(generator() % 8)};
+            records[0][i] = {key, i};
+            records[1][i] = {42, i};
+            doubles[i] = static_cast<double>(static_cast<int>(generator() % 20001) - 10000) / 8;
+        }
+        Sorting allCores{0};
+        Sorting fourThreads{4};
+        bool correct{true};
+        for (Sorting* sorter : {&sorting, &allCores, &fourThreads}) {
+            for (const std::vector<Record>& input : records) {
+                for (size_t length : {size_t{20}, size_t{1000}, size}) {
+                    std::vector<Record> vec(input.begin(), input.begin() + length);
+                    std::vector<Record> reference{vec};
+                    std::stable_sort(reference.begin(), reference.end());
+                    sorter->bucketSort(vec);
+                    correct = correct && vec == reference;
+                }
+            }
+            std::vector<double> vec{doubles};
+            std::vector<double> reference{doubles};
+            std::stable_sort(reference.begin(), reference.end());
+            sorter->bucketSort(vec);
+            correct = correct && vec == reference;
+        }
+        passed = passed && correct;
+        std::cout << "skewed records, doubles, serial and parallel: " 
+                  << (correct ? "match std::stable_sort" : "FAILED") << std::endl;
+    }
+
+    return passed ? 0 : 1;
 }
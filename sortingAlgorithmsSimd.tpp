@@ -0,0 +1,440 @@
+// ***********************************************************************
+//                            Vectorized Kernels
+// ***********************************************************************
+//
+// ** Characteristics: **
+//  - Used by quickSort and mergeSort for std::int32_t, std::int64_t, float and double
+//    when the CPU supports AVX2 or AVX-512 (see simdLevel()); every other type, CPU or
+//    instrumentation policy runs the scalar code.
+//  - The ISA is picked once at run time, so no -mavx2 / -march flag is needed: the
+//    kernels in sortingAlgorithmsSimdKernels.tpp are compiled twice, once inside an
+//    AVX2 target region and once inside an AVX-512 one, each against its own Vector<T>
+//    traits.
+//  - Setting the environment variable SORTING_SIMD to "scalar" or "avx2" caps the level,
+//    which is how the benchmark compares the kernels with the scalar code.
+//  - Defining SORTING_NO_SIMD before including the header removes the kernels entirely.
+//
+// ***********************************************************************
+
+namespace sortingDetail::simd {
+
+inline constexpr size_t networkMaxSize{64};
+
+template <typename T>
+inline constexpr bool supported{std::is_same_v<T, std::int32_t> || std::is_same_v<T, std::int64_t>
+                                || std::is_same_v<T, float> || std::is_same_v<T, double>};
+
+inline SimdLevel detectLevel() {
+#if SORTING_SIMD
+    SimdLevel level{SimdLevel::scalar};
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        level = SimdLevel::avx2;
+    }
+    if (__builtin_cpu_supports("avx512f")) {
+        level = SimdLevel::avx512;
+    }
+    if (const char* requested{std::getenv("SORTING_SIMD")}) {
+        std::string_view name{requested};
+        if (name == "scalar") {
+            level = SimdLevel::scalar;
+        }
+        else if (name == "avx2") {
+            level = std::min(level, SimdLevel::avx2);
+        }
+    }
+    return level;
+#else
+    return SimdLevel::scalar;
+#endif
+}
+
+}
+
+inline SimdLevel simdLevel() {
+    static const SimdLevel level{sortingDetail::simd::detectLevel()};
+    return level;
+}
+
+inline const char* simdLevelName(SimdLevel level) {
+    static constexpr const char* names[]{"scalar", "avx2", "avx512"};
+    return names[static_cast<size_t>(level)];
+}
+
+#if SORTING_SIMD
+
+#if defined(__clang__)
+#define SORTING_SIMD_BEGIN_TARGET(isa) _Pragma("clang attribute push (__attribute__((target(" #isa "))), apply_to = function)")
+#define SORTING_SIMD_END_TARGET _Pragma("clang attribute pop")
+#else
+#define SORTING_SIMD_PRAGMA(text) _Pragma(#text)
+#define SORTING_SIMD_BEGIN_TARGET(isa) _Pragma("GCC push_options") SORTING_SIMD_PRAGMA(GCC target(isa))
+#define SORTING_SIMD_END_TARGET _Pragma("GCC pop_options")
+#endif
+
+namespace sortingDetail::simd {
+
+// Bits of the lanes whose index has `distance` set, i.e. the upper lane of every pair
+// that a compare-exchange at that distance touches.
+template <size_t Lanes>
+constexpr unsigned upperLanes(size_t distance) {
+    unsigned bits{};
+    for (size_t lane{}; lane < Lanes; ++lane) {
+        if (lane & distance) {
+            bits |= 1u << lane;
+        }
+    }
+    return bits;
+}
+
+// AVX2 has no compress instruction: partitionLanes() permutes with a table entry that
+// lists the lanes whose mask bit is set, then the others, one index byte per 32-bit word.
+template <size_t Lanes>
+constexpr std::array<std::uint64_t, (size_t{1} << Lanes)> makePartitionTable() {
+    std::array<std::uint64_t, (size_t{1} << Lanes)> table{};
+    constexpr size_t words{8 / Lanes};
+    for (size_t mask{}; mask < table.size(); ++mask) {
+        size_t slot{};
+        for (bool selected : {true, false}) {
+            for (size_t lane{}; lane < Lanes; ++lane) {
+                if (((mask >> lane) & 1) != selected) {
+                    continue;
+                }
+                for (size_t word{}; word < words; ++word) {
+                    table[mask] |= static_cast<std::uint64_t>(lane * words + word) << (8 * slot++);
+                }
+            }
+        }
+    }
+    return table;
+}
+
+inline constexpr std::array<std::uint64_t, 256> partitionTable8{makePartitionTable<8>()};
+inline constexpr std::array<std::uint64_t, 16> partitionTable4{makePartitionTable<4>()};
+
+// Floating-point keys are sorted by networks as signed integers with the same order:
+// flipping the magnitude bits of negative values makes the integer order match, and
+// since the mapping keeps the sign bit it is its own inverse.
+template <typename T>
+using NetworkKey = std::conditional_t<std::is_floating_point_v<T>,
+                                      std::conditional_t<sizeof(T) == 4, std::int32_t, std::int64_t>, T>;
+
+template <typename T>
+NetworkKey<T> networkKey(T value) {
+    if constexpr (std::is_floating_point_v<T>) {
+        using Key = NetworkKey<T>;
+        Key bits{std::bit_cast<Key>(value)};
+        return bits ^ ((bits >> (8 * sizeof(Key) - 1)) & std::numeric_limits<Key>::max());
+    }
+    else {
+        return value;
+    }
+}
+
+template <typename T>
+T fromNetworkKey(NetworkKey<T> key) {
+    if constexpr (std::is_floating_point_v<T>) {
+        return std::bit_cast<T>(networkKey(std::bit_cast<T>(key)));
+    }
+    else {
+        return key;
+    }
+}
+
+SORTING_SIMD_BEGIN_TARGET("avx2,popcnt")
+namespace avx2 {
+
+// Data movement shared by the 32-bit lane types (8 lanes) ...
+struct Lanes32 {
+    using Register = __m256i;
+    static constexpr size_t lanes{8};
+
+    static Register load(const void* from) { return _mm256_loadu_si256(static_cast<const __m256i*>(from)); }
+    static void store(void* to, Register value) { _mm256_storeu_si256(static_cast<__m256i*>(to), value); }
+    static Register blend(unsigned mask, Register a, Register b) {
+        const __m256i bits{_mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128)};
+        __m256i selected{_mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(static_cast<int>(mask)), bits), bits)};
+        return _mm256_blendv_epi8(a, b, selected);
+    }
+    static Register swapLanes(Register value, size_t distance) {
+        __m256i index{_mm256_xor_si256(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                       _mm256_set1_epi32(static_cast<int>(distance)))};
+        return _mm256_permutevar8x32_epi32(value, index);
+    }
+    static Register reverse(Register value) {
+        return _mm256_permutevar8x32_epi32(value, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+    }
+    static Register partitionLanes(Register value, unsigned mask) {
+        __m128i packed{_mm_cvtsi64_si128(static_cast<long long>(partitionTable8[mask]))};
+        return _mm256_permutevar8x32_epi32(value, _mm256_cvtepu8_epi32(packed));
+    }
+};
+
+// ... and by the 64-bit lane types (4 lanes).
+struct Lanes64 {
+    using Register = __m256i;
+    static constexpr size_t lanes{4};
+
+    static Register load(const void* from) { return _mm256_loadu_si256(static_cast<const __m256i*>(from)); }
+    static void store(void* to, Register value) { _mm256_storeu_si256(static_cast<__m256i*>(to), value); }
+    static Register blend(unsigned mask, Register a, Register b) {
+        const __m256i bits{_mm256_setr_epi64x(1, 2, 4, 8)};
+        __m256i selected{_mm256_cmpeq_epi64(_mm256_and_si256(_mm256_set1_epi64x(mask), bits), bits)};
+        return _mm256_blendv_epi8(a, b, selected);
+    }
+    static Register swapLanes(Register value, size_t distance) {
+        __m256i index{_mm256_xor_si256(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                       _mm256_set1_epi32(static_cast<int>(2 * distance)))};
+        return _mm256_permutevar8x32_epi32(value, index);
+    }
+    static Register reverse(Register value) { return _mm256_permute4x64_epi64(value, 0x1B); }
+    static Register partitionLanes(Register value, unsigned mask) {
+        __m128i packed{_mm_cvtsi64_si128(static_cast<long long>(partitionTable4[mask]))};
+        return _mm256_permutevar8x32_epi32(value, _mm256_cvtepu8_epi32(packed));
+    }
+};
+
+template <typename T>
+struct Vector;
+
+template <>
+struct Vector<std::int32_t> : Lanes32 {
+    static Register broadcast(std::int32_t value) { return _mm256_set1_epi32(value); }
+    static unsigned lessMask(Register a, Register b) {
+        return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(b, a))));
+    }
+    static Register minimum(Register a, Register b) { return _mm256_min_epi32(a, b); }
+    static Register maximum(Register a, Register b) { return _mm256_max_epi32(a, b); }
+};
+
+template <>
+struct Vector<std::int64_t> : Lanes64 {
+    static Register broadcast(std::int64_t value) { return _mm256_set1_epi64x(value); }
+    static unsigned lessMask(Register a, Register b) {
+        return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(b, a))));
+    }
+    static Register minimum(Register a, Register b) { return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b)); }
+    static Register maximum(Register a, Register b) { return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b)); }
+};
+
+template <>
+struct Vector<float> : Lanes32 {
+    static Register broadcast(float value) { return _mm256_castps_si256(_mm256_set1_ps(value)); }
+    static unsigned lessMask(Register a, Register b) {
+        return static_cast<unsigned>(_mm256_movemask_ps(
+            _mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_LT_OQ)));
+    }
+};
+
+template <>
+struct Vector<double> : Lanes64 {
+    static Register broadcast(double value) { return _mm256_castpd_si256(_mm256_set1_pd(value)); }
+    static unsigned lessMask(Register a, Register b) {
+        return static_cast<unsigned>(_mm256_movemask_pd(
+            _mm256_cmp_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_LT_OQ)));
+    }
+};
+
+#include "sortingAlgorithmsSimdKernels.tpp"
+
+}
+SORTING_SIMD_END_TARGET
+
+// GCC 12 reports the _mm512_undefined_epi32() inside several AVX-512 intrinsics as an 
+// uninitialized read once they are inlined here.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+SORTING_SIMD_BEGIN_TARGET("avx512f,avx2,popcnt")
+namespace avx512 {
+
+struct Lanes32 {
+    using Register = __m512i;
+    static constexpr size_t lanes{16};
+
+    static Register load(const void* from) { return _mm512_loadu_si512(from); }
+    static void store(void* to, Register value) { _mm512_storeu_si512(to, value); }
+    static Register blend(unsigned mask, Register a, Register b) {
+        return _mm512_mask_blend_epi32(static_cast<__mmask16>(mask), a, b);
+    }
+    static Register swapLanes(Register value, size_t distance) {
+        __m512i index{_mm512_xor_si512(_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+                                       _mm512_set1_epi32(static_cast<int>(distance)))};
+        return _mm512_permutexvar_epi32(index, value);
+    }
+    static Register reverse(Register value) {
+        return _mm512_permutexvar_epi32(_mm512_setr_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0), value);
+    }
+    static Register partitionLanes(Register value, unsigned mask) {
+        __m512i selected{_mm512_maskz_compress_epi32(static_cast<__mmask16>(mask), value)};
+        __m512i others{_mm512_maskz_compress_epi32(static_cast<__mmask16>(~mask), value)};
+        return _mm512_mask_expand_epi32(selected, static_cast<__mmask16>(0xFFFFu << std::popcount(mask)), others);
+    }
+};
+
+struct Lanes64 {
+    using Register = __m512i;
+    static constexpr size_t lanes{8};
+
+    static Register load(const void* from) { return _mm512_loadu_si512(from); }
+    static void store(void* to, Register value) { _mm512_storeu_si512(to, value); }
+    static Register blend(unsigned mask, Register a, Register b) {
+        return _mm512_mask_blend_epi64(static_cast<__mmask8>(mask), a, b);
+    }
+    static Register swapLanes(Register value, size_t distance) {
+        __m512i index{_mm512_xor_si512(_mm512_setr_epi64(0, 1, 2, 3, 4, 5, 6, 7),
+                                       _mm512_set1_epi64(static_cast<long long>(distance)))};
+        return _mm512_permutexvar_epi64(index, value);
+    }
+    static Register reverse(Register value) {
+        return _mm512_permutexvar_epi64(_mm512_setr_epi64(7, 6, 5, 4, 3, 2, 1, 0), value);
+    }
+    static Register partitionLanes(Register value, unsigned mask) {
+        __m512i selected{_mm512_maskz_compress_epi64(static_cast<__mmask8>(mask), value)};
+        __m512i others{_mm512_maskz_compress_epi64(static_cast<__mmask8>(~mask), value)};
+        return _mm512_mask_expand_epi64(selected, static_cast<__mmask8>(0xFFu << std::popcount(mask)), others);
+    }
+};
+
+template <typename T>
+struct Vector;
+
+template <>
+struct Vector<std::int32_t> : Lanes32 {
+    static Register broadcast(std::int32_t value) { return _mm512_set1_epi32(value); }
+    static unsigned lessMask(Register a, Register b) { return _mm512_cmplt_epi32_mask(a, b); }
+    static Register minimum(Register a, Register b) { return _mm512_min_epi32(a, b); }
+    static Register maximum(Register a, Register b) { return _mm512_max_epi32(a, b); }
+};
+
+template <>
+struct Vector<std::int64_t> : Lanes64 {
+    static Register broadcast(std::int64_t value) { return _mm512_set1_epi64(value); }
+    static unsigned lessMask(Register a, Register b) { return _mm512_cmplt_epi64_mask(a, b); }
+    static Register minimum(Register a, Register b) { return _mm512_min_epi64(a, b); }
+    static Register maximum(Register a, Register b) { return _mm512_max_epi64(a, b); }
+};
+
+template <>
+struct Vector<float> : Lanes32 {
+    static Register broadcast(float value) { return _mm512_castps_si512(_mm512_set1_ps(value)); }
+    static unsigned lessMask(Register a, Register b) {
+        return _mm512_cmp_ps_mask(_mm512_castsi512_ps(a), _mm512_castsi512_ps(b), _CMP_LT_OQ);
+    }
+};
+
+template <>
+struct Vector<double> : Lanes64 {
+    static Register broadcast(double value) { return _mm512_castpd_si512(_mm512_set1_pd(value)); }
+    static unsigned lessMask(Register a, Register b) {
+        return _mm512_cmp_pd_mask(_mm512_castsi512_pd(a), _mm512_castsi512_pd(b), _CMP_LT_OQ);
+    }
+};
+
+#include "sortingAlgorithmsSimdKernels.tpp"
+
+}
+SORTING_SIMD_END_TARGET
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+}
+
+#endif
+
+namespace sortingDetail::simd {
+
+// Entry points used by BasicSorting. Each returns false when it did nothing, either
+// because no vector ISA is available or because the input is too small for the kernel;
+// the caller then runs its scalar code.
+
+template <typename T>
+bool sortNetwork([[maybe_unused]] T* data, [[maybe_unused]] size_t size) {
+#if SORTING_SIMD
+    if (size <= networkMaxSize) {
+        switch (simdLevel()) {
+        case SimdLevel::avx512:
+            avx512::sortNetwork(data, size);
+            return true;
+        case SimdLevel::avx2:
+            avx2::sortNetwork(data, size);
+            return true;
+        case SimdLevel::scalar:
+            break;
+        }
+    }
+#endif
+    return false;
+}
+
+// Partitions data[0, size) so that keys less than the pivot (or not greater than it,
+// with OrEqual) come first; lessCount receives how many there are.
+template <bool OrEqual, typename T>
+bool partition([[maybe_unused]] T* data, [[maybe_unused]] size_t size, [[maybe_unused]] T pivot,
+               [[maybe_unused]] size_t& lessCount) {
+#if SORTING_SIMD
+    switch (simdLevel()) {
+    case SimdLevel::avx512:
+        if (size >= 2 * avx512::Vector<T>::lanes) {
+            lessCount = avx512::partition<OrEqual>(data, size, pivot);
+            return true;
+        }
+        break;
+    case SimdLevel::avx2:
+        if (size >= 2 * avx2::Vector<T>::lanes) {
+            lessCount = avx2::partition<OrEqual>(data, size, pivot);
+            return true;
+        }
+        break;
+    case SimdLevel::scalar:
+        break;
+    }
+#endif
+    return false;
+}
+
+// Lanes of one register for T at the current level, 0 without vector support.
+template <typename T>
+size_t registerWidth() {
+#if SORTING_SIMD
+    switch (simdLevel()) {
+    case SimdLevel::avx512:
+        return avx512::Vector<T>::lanes;
+    case SimdLevel::avx2:
+        return avx2::Vector<T>::lanes;
+    case SimdLevel::scalar:
+        break;
+    }
+#endif
+    return 0;
+}
+
+// Merges two sorted integer runs into out.
+template <typename T>
+bool merge([[maybe_unused]] const T* left, [[maybe_unused]] size_t leftSize,
+           [[maybe_unused]] const T* right, [[maybe_unused]] size_t rightSize, [[maybe_unused]] T* out) {
+#if SORTING_SIMD
+    switch (simdLevel()) {
+    case SimdLevel::avx512:
+        if (std::min(leftSize, rightSize) >= avx512::Vector<T>::lanes) {
+            avx512::merge(left, leftSize, right, rightSize, out);
+            return true;
+        }
+        break;
+    case SimdLevel::avx2:
+        if (std::min(leftSize, rightSize) >= avx2::Vector<T>::lanes) {
+            avx2::merge(left, leftSize, right, rightSize, out);
+            return true;
+        }
+        break;
+    case SimdLevel::scalar:
+        break;
+    }
+#endif
+    return false;
+}
+
+}
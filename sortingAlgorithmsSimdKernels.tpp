@@ -0,0 +1,195 @@
+// Vector kernels, written once against the Vector<T> traits of the namespace that
+// includes this file. sortingAlgorithmsSimd.tpp includes it once per instruction set,
+// so there is deliberately no include guard.
+//
+// Every Vector<T> provides load(), store(), broadcast(), lessMask() (bit i set when
+// lane i of a is less than lane i of b), blend() (lane i taken from b when mask bit i
+// is set), swapLanes() (lane i taken from lane i ^ distance), reverse() and
+// partitionLanes() (lanes whose mask bit is set first, in order, then the others).
+// The integer traits add minimum() and maximum().
+
+// Sorts data[0, size), size <= networkMaxSize, with a bitonic sorting network. The keys
+// are padded with the largest key up to a power of two of at least one register. Stages
+// whose partners are a register or more apart are lane-wise min/max of two registers;
+// closer partners are brought into the same lane with swapLanes().
+template <typename T>
+void sortNetwork(T* data, size_t size) {
+    using Key = NetworkKey<T>;
+    using V = Vector<Key>;
+    constexpr size_t lanes{V::lanes};
+    constexpr unsigned allLanes{(1u << lanes) - 1};
+    size_t padded{std::max(lanes, std::bit_ceil(size))};
+    alignas(64) Key keys[networkMaxSize];
+    for (size_t i{}; i < size; ++i) {
+        keys[i] = networkKey(data[i]);
+    }
+    std::fill(keys + size, keys + padded, std::numeric_limits<Key>::max());
+
+    for (size_t blockSize{2}; blockSize <= padded; blockSize *= 2) {
+        for (size_t distance{blockSize / 2}; distance > 0; distance /= 2) {
+            if (distance >= lanes) {
+                for (size_t i{}; i < padded; i += lanes) {
+                    if (i & distance) {
+                        continue;
+                    }
+                    auto low{V::load(keys + i)};
+                    auto high{V::load(keys + i + distance)};
+                    auto smaller{V::minimum(low, high)};
+                    auto larger{V::maximum(low, high)};
+                    bool descending{(i & blockSize) != 0};
+                    V::store(keys + i, descending ? larger : smaller);
+                    V::store(keys + i + distance, descending ? smaller : larger);
+                }
+                continue;
+            }
+            // A lane keeps the maximum of its pair when it is the upper lane of an
+            // ascending block or the lower lane of a descending one.
+            unsigned upper{upperLanes<lanes>(distance)};
+            unsigned descendingLanes{blockSize < lanes ? upperLanes<lanes>(blockSize) : 0};
+            for (size_t i{}; i < padded; i += lanes) {
+                unsigned descending{blockSize < lanes ? descendingLanes : ((i & blockSize) ? allLanes : 0)};
+                auto value{V::load(keys + i)};
+                auto partner{V::swapLanes(value, distance)};
+                V::store(keys + i, V::blend(upper ^ descending, V::minimum(value, partner), V::maximum(value, partner)));
+            }
+        }
+    }
+    for (size_t i{}; i < size; ++i) {
+        data[i] = fromNetworkKey<T>(keys[i]);
+    }
+}
+
+// Partitions data[0, size), size >= 2 * lanes, around the pivot and returns the number
+// of keys sent left: keys less than the pivot, or not greater than it with OrEqual.
+// The first and last register are held back, which leaves a gap of at least one
+// register on each side; every register read is packed by partitionLanes() and the
+// packed register is stored whole at both write positions, the left keys landing at
+// the left end and the right keys at the right end. Reading from the side with the
+// smaller gap keeps both gaps wide enough for those full-width stores.
+template <bool OrEqual, typename T>
+size_t partition(T* data, size_t size, T pivot) {
+    using V = Vector<T>;
+    constexpr size_t lanes{V::lanes};
+    constexpr unsigned allLanes{(1u << lanes) - 1};
+    auto pivots{V::broadcast(pivot)};
+    auto heldLeft{V::load(data)};
+    auto heldRight{V::load(data + size - lanes)};
+    T* readLeft{data + lanes};
+    T* readRight{data + size - lanes};
+    T* writeLeft{data};
+    T* writeRight{data + size};
+
+    while (static_cast<size_t>(readRight - readLeft) >= lanes) {
+        typename V::Register value;
+        if (readLeft - writeLeft <= writeRight - readRight) {
+            value = V::load(readLeft);
+            readLeft += lanes;
+        }
+        else {
+            readRight -= lanes;
+            value = V::load(readRight);
+        }
+        unsigned toLeft{OrEqual ? ~V::lessMask(pivots, value) & allLanes : V::lessMask(value, pivots)};
+        auto packed{V::partitionLanes(value, toLeft)};
+        size_t leftCount{static_cast<size_t>(std::popcount(toLeft))};
+        V::store(writeLeft, packed);
+        V::store(writeRight - lanes, packed);
+        writeLeft += leftCount;
+        writeRight -= lanes - leftCount;
+    }
+
+    // The unread tail and the two held registers exactly fill the remaining gap.
+    alignas(64) T rest[3 * lanes];
+    size_t restSize{static_cast<size_t>(readRight - readLeft)};
+    std::copy(readLeft, readRight, rest);
+    V::store(rest + restSize, heldLeft);
+    V::store(rest + restSize + lanes, heldRight);
+    for (size_t i{}; i < restSize + 2 * lanes; ++i) {
+        if (OrEqual ? !(pivot < rest[i]) : rest[i] < pivot) {
+            *writeLeft++ = rest[i];
+        }
+        else {
+            *--writeRight = rest[i];
+        }
+    }
+    return static_cast<size_t>(writeLeft - data);
+}
+
+// Merges two sorted registers: afterwards low holds the smaller half in order and high
+// the larger half. Reversing high makes the pair one bitonic sequence, which a min/max
+// across the registers splits into two bitonic halves that are cleaned in-register.
+template <typename V>
+void bitonicMerge(typename V::Register& low, typename V::Register& high) {
+    constexpr size_t lanes{V::lanes};
+    high = V::reverse(high);
+    auto smaller{V::minimum(low, high)};
+    high = V::maximum(low, high);
+    low = smaller;
+    for (size_t distance{lanes / 2}; distance > 0; distance /= 2) {
+        unsigned upper{upperLanes<lanes>(distance)};
+        auto lowPartner{V::swapLanes(low, distance)};
+        auto highPartner{V::swapLanes(high, distance)};
+        low = V::blend(upper, V::minimum(low, lowPartner), V::maximum(low, lowPartner));
+        high = V::blend(upper, V::minimum(high, highPartner), V::maximum(high, highPartner));
+    }
+}
+
+// Merges two sorted integer runs of at least one register each into out. One register
+// of the output is produced per step: the next register is loaded from the run whose
+// next key is smaller and merged with the larger half of the previous step. Once
+// either run has less than a register left, the carried keys and both tails are
+// merged one key at a time. out may overlap the end of one run, as long as it starts
+// no later than that run minus the length of the other: output never overtakes input.
+template <typename T>
+void merge(const T* left, size_t leftSize, const T* right, size_t rightSize, T* out) {
+    using V = Vector<T>;
+    constexpr size_t lanes{V::lanes};
+    const T* leftEnd{left + leftSize};
+    const T* rightEnd{right + rightSize};
+    auto low{V::load(left)};
+    auto high{V::load(right)};
+    left += lanes;
+    right += lanes;
+    bitonicMerge<V>(low, high);
+    V::store(out, low);
+    out += lanes;
+    while (static_cast<size_t>(leftEnd - left) >= lanes && static_cast<size_t>(rightEnd - right) >= lanes) {
+        if (*left < *right) {
+            low = V::load(left);
+            left += lanes;
+        }
+        else {
+            low = V::load(right);
+            right += lanes;
+        }
+        bitonicMerge<V>(low, high);
+        V::store(out, low);
+        out += lanes;
+    }
+
+    alignas(64) T carried[lanes];
+    V::store(carried, high);
+    size_t next{};
+    while (next < lanes) {
+        bool leftSmallest{left < leftEnd && *left < carried[next] && (right == rightEnd || !(*right < *left))};
+        if (leftSmallest) {
+            *out++ = *left++;
+        }
+        else if (right < rightEnd && *right < carried[next]) {
+            *out++ = *right++;
+        }
+        else {
+            *out++ = carried[next++];
+        }
+    }
+    while (left < leftEnd && right < rightEnd) {
+        *out++ = *right < *left ? *right++ : *left++;
+    }
+    // Element-wise, since powerSort merges with one run already in place at the output.
+    while (left < leftEnd) {
+        *out++ = *left++;
+    }
+    while (right < rightEnd) {
+        *out++ = *right++;
+    }
+}